@@ -0,0 +1,430 @@
+# -*- coding: utf-8 -*-
+#
+# run_benchmarks.py
+#
+# This file is part of DeNSE.
+#
+# Copyright (C) 2019 SeNEC Initiative
+#
+# DeNSE is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# DeNSE is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with DeNSE. If not, see <http://www.gnu.org/licenses/>.
+
+
+"""
+Performance benchmarks on a fixed set of reproducible cultures.
+
+Each workload runs in its own process (so that the peak RSS is meaningful)
+and reports, as JSON:
+
+* the wall-clock duration of each phase (kernel setup, neuron creation,
+  simulation, network generation),
+* the number of simulation steps per second,
+* the number of growth-cone steps per second (estimated from the number of
+  growth cones before and after the simulation),
+* the peak resident set size,
+* the kernel profile of the simulation (time spent in each part of the
+  simulation loop and number of R-tree queries, intersections, etc.).
+
+Usage::
+
+    python benchmarks/run_benchmarks.py [-o results.json] [-t threads]
+                                        [-w workload ...]
+
+or ``make benchmark`` from the build directory.
+"""
+
+import argparse
+import datetime
+import json
+import os
+import resource
+import subprocess
+import sys
+import time
+
+import numpy as np
+
+
+root_dir     = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+examples_dir = os.path.join(root_dir, "examples")
+
+seed = 42
+
+
+# ---------------- #
+# Common utilities #
+# ---------------- #
+
+class PhaseTimer(object):
+
+    ''' Record the duration of successive phases '''
+
+    def __init__(self):
+        self.phases = {}
+
+    def __call__(self, name):
+        return _Phase(self, name)
+
+
+class _Phase(object):
+
+    def __init__(self, timer, name):
+        self.timer = timer
+        self.name  = name
+
+    def __enter__(self):
+        self.start = time.perf_counter()
+
+    def __exit__(self, *args):
+        self.timer.phases[self.name] = time.perf_counter() - self.start
+
+
+def _setup_kernel(ds, num_omp, resolution, **kwargs):
+    ds.reset_kernel()
+
+    kernel = {
+        "seeds": [seed + i for i in range(num_omp)],
+        "num_local_threads": num_omp,
+        "resolution": resolution,
+        "environment_required": False,
+        "profiling": True,
+    }
+
+    kernel.update(kwargs)
+
+    ds.set_kernel_status(kernel)
+
+
+def _num_growth_cones(ds, neurons):
+    return int(np.sum(ds.get_object_state(neurons, "num_growth_cones",
+                                          return_iterable=True)))
+
+
+def _base_params(ds, **kwargs):
+    from dense.units import deg, minute, um
+
+    params = {
+        "growth_cone_model": "run-and-tumble",
+        "sensing_angle": 45.*deg,
+        "speed_growth_cone": 0.1*um/minute,
+        "persistence_length": 300.*um,
+        "filopodia_finger_length": 10.*um,
+        "filopodia_min_number": 30,
+        "soma_radius": 8.*um,
+    }
+
+    params.update(kwargs)
+
+    return params
+
+
+# --------- #
+# Workloads #
+# --------- #
+
+def free_space(ds, timer, num_omp):
+    ''' Non-interacting neurons in free space '''
+    from dense.units import day, minute, um
+
+    with timer("setup"):
+        _setup_kernel(ds, num_omp, 10.*minute, interactions=False)
+
+    rng = np.random.RandomState(seed)
+
+    params = _base_params(
+        ds, position=rng.uniform(-2000, 2000, (100, 2))*um)
+
+    with timer("create"):
+        neurons = ds.create_neurons(100, params, num_neurites=3)
+
+    return neurons, 2.*day
+
+
+def dense_culture(ds, timer, num_omp):
+    ''' Many interacting neurons in a small area '''
+    from dense.units import day, minute, um
+
+    with timer("setup"):
+        _setup_kernel(ds, num_omp, 10.*minute)
+
+    rng = np.random.RandomState(seed)
+
+    params = _base_params(
+        ds, position=rng.uniform(-300, 300, (500, 2))*um)
+
+    with timer("create"):
+        neurons = ds.create_neurons(500, params, num_neurites=3)
+
+    return neurons, 1.*day
+
+
+def _culture(ds, timer, num_omp, culture_file, max_x, num_neurons):
+    from dense.units import day, minute
+
+    with timer("setup"):
+        _setup_kernel(ds, num_omp, 30.*minute, environment_required=True,
+                      adaptive_timestep=-1.)
+        culture = ds.set_environment(culture_file, min_x=0, max_x=max_x)
+
+    params = _base_params(ds, filopodia_wall_affinity=2.)
+
+    with timer("create"):
+        neurons = ds.create_neurons(num_neurons, params, num_neurites=2,
+                                    culture=culture)
+
+    return neurons, 2.*day
+
+
+def two_chambers(ds, timer, num_omp):
+    ''' Environment of `examples/2chambers` '''
+    return _culture(
+        ds, timer, num_omp,
+        os.path.join(examples_dir, "2chambers",
+                     "2chamber_culture_sharpen.svg"), 1500, 200)
+
+
+def arches(ds, timer, num_omp):
+    ''' Environment of `examples/arches` '''
+    return _culture(
+        ds, timer, num_omp,
+        os.path.join(examples_dir, "arches", "arches_3.svg"), 800, 100)
+
+
+def van_pelt_branching(ds, timer, num_omp):
+    ''' Branching through the van Pelt model '''
+    from dense.units import day, minute, um
+
+    with timer("setup"):
+        _setup_kernel(ds, num_omp, 10.*minute, interactions=False)
+
+    rng = np.random.RandomState(seed)
+
+    params = _base_params(
+        ds, position=rng.uniform(-2000, 2000, (50, 2))*um, use_van_pelt=True,
+        B=10.8, T=200.*minute, E=0., S=-2.)
+
+    with timer("create"):
+        neurons = ds.create_neurons(50, params, num_neurites=2)
+
+    return neurons, 2.*day
+
+
+def lateral_branching(ds, timer, num_omp):
+    ''' Lateral branching with a constant rate '''
+    from dense.units import cpm, day, deg, minute, um
+
+    with timer("setup"):
+        _setup_kernel(ds, num_omp, 10.*minute, interactions=False)
+
+    rng = np.random.RandomState(seed)
+
+    params = _base_params(
+        ds, position=rng.uniform(-2000, 2000, (50, 2))*um,
+        use_van_pelt=False, use_flpl_branching=True,
+        flpl_branching_rate=0.002*cpm,
+        lateral_branching_angle_mean=25.*deg)
+
+    with timer("create"):
+        neurons = ds.create_neurons(50, params, num_neurites=2)
+
+    return neurons, 2.*day
+
+
+def heavy_recording(ds, timer, num_omp):
+    ''' Continuous recording of several growth cone observables '''
+    from dense.units import day, minute, um
+
+    with timer("setup"):
+        _setup_kernel(ds, num_omp, 10.*minute)
+
+    rng = np.random.RandomState(seed)
+
+    params = _base_params(
+        ds, position=rng.uniform(-1000, 1000, (100, 2))*um)
+
+    with timer("create"):
+        neurons = ds.create_neurons(100, params, num_neurites=3)
+        ds.create_recorders(neurons, ["length", "speed"],
+                            levels="growth_cone")
+        ds.create_recorders(neurons, "num_growth_cones", levels="neuron")
+
+    return neurons, 1.*day
+
+
+def synapse_generation(ds, timer, num_omp):
+    ''' Dense culture followed by network generation '''
+    from dense.units import um
+
+    neurons, duration = dense_culture(ds, timer, num_omp)
+
+    def network():
+        with timer("network_intersections"):
+            ds.morphology.generate_network(method="intersections")
+
+        with timer("network_spines"):
+            ds.morphology.generate_network(method="spines",
+                                           max_spine_length=4.*um)
+
+    return neurons, duration, network
+
+
+def _large_culture(ds, timer, num_omp, compact):
+    from dense.units import day, minute, um
+
+    with timer("setup"):
+        _setup_kernel(ds, num_omp, 10.*minute, interactions=False,
+                      compact_geometry=compact)
+
+    rng = np.random.RandomState(seed)
+
+    params = _base_params(
+        ds, position=rng.uniform(-10000, 10000, (5000, 2))*um)
+
+    with timer("create"):
+        neurons = ds.create_neurons(5000, params, num_neurites=3)
+
+    return neurons, 2.*day
+
+
+def large_culture(ds, timer, num_omp):
+    ''' Many non-interacting neurons (memory reference) '''
+    return _large_culture(ds, timer, num_omp, False)
+
+
+def large_culture_compact(ds, timer, num_omp):
+    ''' `large_culture` with the "compact_geometry" storage '''
+    return _large_culture(ds, timer, num_omp, True)
+
+
+workloads = [
+    free_space, dense_culture, two_chambers, arches, van_pelt_branching,
+    lateral_branching, heavy_recording, synapse_generation, large_culture,
+    large_culture_compact,
+]
+
+
+# ------ #
+# Runner #
+# ------ #
+
+def run_workload(name, num_omp):
+    ''' Run one workload in the current process and return its results '''
+    import dense as ds
+
+    workload = {w.__name__: w for w in workloads}[name]
+    timer    = PhaseTimer()
+    res      = workload(ds, timer, num_omp)
+    post     = res[2] if len(res) > 2 else None
+
+    neurons, duration = res[0], res[1]
+
+    resolution = ds.get_kernel_status("resolution")
+    num_steps  = int(round(float(duration / resolution)))
+
+    gc_start = _num_growth_cones(ds, neurons)
+
+    with timer("simulate"):
+        ds.simulate(duration)
+
+    gc_stop = _num_growth_cones(ds, neurons)
+    profile = ds.get_kernel_status("profile")
+
+    if post is not None:
+        post()
+
+    sim_time = timer.phases["simulate"]
+
+    # ru_maxrss is given in kB on Linux and in bytes on macOS
+    rss = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+
+    if sys.platform == "darwin":
+        rss /= 1024.
+
+    return {
+        "workload": name,
+        "description": workload.__doc__.strip(),
+        "num_threads": num_omp,
+        "num_neurons": len(neurons),
+        "num_steps": num_steps,
+        "growth_cones": [gc_start, gc_stop],
+        "steps_per_s": num_steps / sim_time,
+        "growth_cone_steps_per_s":
+            0.5*(gc_start + gc_stop)*num_steps / sim_time,
+        "peak_rss_MB": rss / 1024.,
+        "phases": timer.phases,
+        "profile": profile,
+    }
+
+
+def _git_revision():
+    try:
+        return subprocess.check_output(
+            ["git", "rev-parse", "HEAD"], cwd=root_dir,
+            stderr=subprocess.DEVNULL).decode().strip()
+    except (OSError, subprocess.CalledProcessError):
+        return None
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+
+    parser.add_argument("-w", "--workload", nargs="*",
+                        choices=[w.__name__ for w in workloads],
+                        help="Workloads to run (default: all).")
+    parser.add_argument("-t", "--threads", type=int, default=1,
+                        help="Number of OpenMP threads.")
+    parser.add_argument("-o", "--output", default=None,
+                        help="JSON file where the results are saved "
+                             "(printed otherwise).")
+    parser.add_argument("--single", action="store_true",
+                        help=argparse.SUPPRESS)
+
+    args = parser.parse_args()
+
+    names = args.workload or [w.__name__ for w in workloads]
+
+    # child process: run one workload and print the JSON result
+    if args.single:
+        print(json.dumps(run_workload(names[0], args.threads)))
+        return
+
+    results = {
+        "revision": _git_revision(),
+        "date": datetime.datetime.now().isoformat(),
+        "num_threads": args.threads,
+        "workloads": [],
+    }
+
+    for name in names:
+        out = subprocess.check_output(
+            [sys.executable, os.path.abspath(__file__), "--single",
+             "-t", str(args.threads), "-w", name])
+
+        # the result is the last line, previous ones come from the kernel
+        res = json.loads(out.decode().strip().split("\n")[-1])
+
+        print("{:<22} {:>10.1f} steps/s {:>12.1f} gc-steps/s {:>8.1f} MB"
+              .format(name, res["steps_per_s"], res["growth_cone_steps_per_s"],
+                      res["peak_rss_MB"]), file=sys.stderr)
+
+        results["workloads"].append(res)
+
+    if args.output is None:
+        print(json.dumps(results, indent=2))
+    else:
+        with open(args.output, "w") as f:
+            json.dump(results, f, indent=2)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,10 @@
+#!/bin/bash
+
+export PYTHONPATH=/tmp/dinstall/lib/python3.11/site-packages:$PYTHONPATH
+export LD_LIBRARY_PATH=/tmp/dinstall/lib:$LD_LIBRARY_PATH
+export PATH=/tmp/dinstall/bin:$PATH
+
+echo "export PYTHONPATH=/tmp/dinstall/lib/python3.11/site-packages:\$PYTHONPATH" >> ~/.bashrc
+echo "export LD_LIBRARY_PATH=/tmp/dinstall/lib:\$LD_LIBRARY_PATH" >> ~/.bashrc
+echo "export PATH=/tmp/dinstall/bin:\$PATH" >> ~/.bashrc
+
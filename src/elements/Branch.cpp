@@ -23,9 +23,16 @@
 
 #define _USE_MATH_DEFINES
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <iostream>
+#include <stdexcept>
+
+#include "kernel_manager.hpp"
+
+
+#define BRANCH_CHUNK_SIZE 64
 
 
 namespace growth
@@ -33,23 +40,22 @@ namespace growth
 
 Branch::Branch()
     : initial_point_(0, 0)
+    , first_({{0., 0., 0.}})
+    , size_(0)
 {
-    std::vector<double> x, y, l;
-    points_ = {{x, y, l}};
 }
 
 
+/**
+ * The copy shares the chunks of `copy`.
+ */
 Branch::Branch(const Branch &copy)
     : initial_point_(copy.initial_point_)
+    , first_(copy.first_)
+    , spans_(copy.spans_)
+    , size_(copy.size_)
     , last_points_(copy.last_points_)
-    , segments_(copy.segments_)
 {
-    points_[0].insert(points_[0].end(), copy.points_[0].begin(),
-                      copy.points_[0].end());
-    points_[1].insert(points_[1].end(), copy.points_[1].begin(),
-                      copy.points_[1].end());
-    points_[2].insert(points_[2].end(), copy.points_[2].begin(),
-                      copy.points_[2].end());
 }
 
 
@@ -61,11 +67,9 @@ Branch::Branch(const BPoint &initial_position, double initial_distance_to_soma)
 {
     initial_point_ = initial_position;
 
-    points_[0].push_back(initial_position.x());
-    points_[1].push_back(initial_position.y());
-    points_[2].push_back(initial_distance_to_soma);
-
-    assert(!points_.empty());
+    first_ = {{initial_position.x(), initial_position.y(),
+               initial_distance_to_soma}};
+    size_  = 1;
 }
 
 
@@ -77,19 +81,15 @@ Branch::~Branch() {}
  *
  * \param BPoint& point in x,y to add to the vector
  * \param double l is required for an easy computation.
- * \param BPolygonPtr poly is the full polygon representing the segment.
+ * \param GeometryPtr geom is the stored polygon representing the segment.
  */
-void Branch::add_point(const BPoint &p, double length, BPolygonPtr poly,
+void Branch::add_point(const BPoint &p, double length, GeometryPtr geom,
                        const BPoint &lp1, const BPoint &lp2)
 {
-    points_[0].push_back(p.x());
-    points_[1].push_back(p.y());
-    points_[2].push_back(points_[2].back() + length);
+    push_entry(p.x(), p.y(), final_distance_to_soma() + length, geom);
 
     last_points_.first  = lp1;
     last_points_.second = lp2;
-
-    segments_.push_back(poly);
 }
 
 
@@ -101,8 +101,9 @@ const std::pair<BPoint, BPoint> &Branch::get_last_points() const
 
 double Branch::module_from_points(const BPoint &p)
 {
-    return sqrt(pow(p.x() - points_[0].back(), 2) +
-                pow(p.y() - points_[1].back(), 2));
+    BPoint last = get_last_xy();
+
+    return sqrt(pow(p.x() - last.x(), 2) + pow(p.y() - last.y(), 2));
 }
 
 
@@ -110,54 +111,34 @@ void Branch::set_first_point(const BPoint &p, double dist_to_soma)
 {
     initial_point_ = p;
 
-    if (points_[0].size() == 0)
-    {
-        points_[0].push_back(p.x());
-        points_[1].push_back(p.y());
-        points_[2].push_back(dist_to_soma);
-    }
-    else
+    // the first point is not stored in the (possibly shared) chunks
+    first_ = {{p.x(), p.y(), dist_to_soma}};
+
+    if (size_ == 0)
     {
-        points_[0][0] = p.x();
-        points_[1][0] = p.y();
-        points_[2][0] = dist_to_soma;
+        size_ = 1;
     }
 }
 
 
 void Branch::retract()
 {
-    points_[0].pop_back();
-    points_[1].pop_back();
-    points_[2].pop_back();
+    stype n = num_entries();
 
-    // recover the new last points
-    if (not segments_.empty())
+    if (n == 0)
     {
-        std::vector<BPoint> new_lp;
-
-        BPolygonPtr last_poly = segments_.back();
-        BRing ring            = last_poly->outer();
-
-        segments_.pop_back();
-
-        if (not segments_.empty())
-        {
-            BPolygonPtr new_last_poly = segments_.back();
+        size_ = 0;
+        return;
+    }
 
-            for (stype i = 0; i < ring.size() - 1; i++)
-            {
-                if (bg::covered_by(ring[i], *(new_last_poly.get())))
-                {
-                    new_lp.push_back(ring[i]);
-                }
-            }
+    // recover the new last points
+    BPolygonPtr last_poly = entry_segment(n - 1);
 
-            assert(new_lp.size() == 2);
+    truncate(n - 1);
 
-            last_points_.first  = new_lp[0];
-            last_points_.second = new_lp[1];
-        }
+    if (n > 1)
+    {
+        update_last_points(last_poly, entry_segment(n - 2));
     }
 }
 
@@ -166,38 +147,24 @@ void Branch::resize_tail(stype new_size)
 {
     assert(new_size <= size());
 
-    points_[0].resize(new_size);
-    points_[1].resize(new_size);
-    points_[2].resize(new_size);
+    if (new_size == 0)
+    {
+        spans_.clear();
+        size_ = 0;
+        return;
+    }
 
     // for segment, set new size
-    stype size_seg = new_size == 0 ? 0 : new_size - 1;
+    stype size_seg = new_size - 1;
 
     // recover the new last points
-    if (size_seg > 0 and size_seg < segments_.size())
+    if (size_seg > 0 and size_seg < num_entries())
     {
-        std::vector<BPoint> new_lp;
-
-        BPolygonPtr end_poly  = segments_[size_seg];
-        BPolygonPtr last_poly = segments_[size_seg - 1];
-
-        auto ring = end_poly->outer();
-
-        for (stype i = 0; i < ring.size() - 1; i++)
-        {
-            if (bg::covered_by(ring[i], *(last_poly.get())))
-            {
-                new_lp.push_back(ring[i]);
-            }
-        }
-
-        assert(new_lp.size() == 2);
-
-        last_points_.first  = new_lp[0];
-        last_points_.second = new_lp[1];
+        update_last_points(entry_segment(size_seg),
+                           entry_segment(size_seg - 1));
     }
 
-    segments_.resize(size_seg);
+    truncate(size_seg);
 }
 
 
@@ -205,6 +172,8 @@ void Branch::resize_tail(stype new_size)
  * @brief Resize the head of the Branch, last segment stay, first segments are
  * cut out.
  *
+ * The new branch shares the chunks of this one.
+ *
  * @param id_x  first element of new Branch
  *
  * @return Branch object of size Branch.size - id_x
@@ -215,27 +184,30 @@ BranchPtr Branch::resize_head(stype id_x) const
 
     BranchPtr new_branch = std::make_shared<Branch>();
 
-    new_branch->points_[0].insert(new_branch->points_[0].end(),
-                                  points_[0].cbegin() + id_x,
-                                  points_[0].cend());
+    new_branch->first_         = at(id_x);
+    new_branch->initial_point_ = BPoint(new_branch->first_[0],
+                                        new_branch->first_[1]);
+    new_branch->size_          = size_ - id_x;
+    new_branch->last_points_   = last_points_;
 
-    new_branch->points_[1].insert(new_branch->points_[1].end(),
-                                  points_[1].cbegin() + id_x,
-                                  points_[1].cend());
+    // keep the entries from id_x on (they end on points id_x + 1 and more)
+    if (id_x < num_entries())
+    {
+        stype pos;
+        const Span &first_span = find_span(id_x, pos);
 
-    new_branch->points_[2].insert(new_branch->points_[2].end(),
-                                  points_[2].cbegin() + id_x,
-                                  points_[2].cend());
+        for (stype i = &first_span - spans_.data(); i < spans_.size(); i++)
+        {
+            Span span = spans_[i];
 
-    // resize segments
-    new_branch->segments_.insert(new_branch->segments_.end(),
-                                 segments_.cbegin() + id_x, segments_.cend());
+            span.begin  = std::max(span.begin, pos);
+            span.offset = std::max(span.offset, id_x) - id_x;
 
-    // set points
-    new_branch->initial_point_ =
-        BPoint(new_branch->points_[0][0], new_branch->points_[0][1]);
+            new_branch->spans_.push_back(span);
 
-    new_branch->last_points_ = last_points_;
+            pos = 0;
+        }
+    }
 
     return new_branch;
 }
@@ -243,10 +215,12 @@ BranchPtr Branch::resize_head(stype id_x) const
 
 /**
  * Append branch (inplace operation)
+ *
+ * The chunks of `appended_branch` are shared, not copied.
  */
 void Branch::append_branch(BranchPtr appended_branch)
 {
-    stype total_size = points_[0].size() + appended_branch->size();
+    stype total_size = size_ + appended_branch->size();
 
     const BPoint lp = get_last_xy();
     const BPoint ip = appended_branch->xy_at(0);
@@ -259,23 +233,23 @@ void Branch::append_branch(BranchPtr appended_branch)
 
     total_size -= dsize;
 
-    // auto id_end = appended_branch->size();
-    points_[0].insert(points_[0].end(),
-                      appended_branch->points_[0].cbegin() + dsize,
-                      appended_branch->points_[0].cend());
+    if (dsize == 0)
+    {
+        // no segment joins the two branches
+        push_entry(ip.x(), ip.y(), appended_branch->first_[2], nullptr);
+    }
 
-    points_[1].insert(points_[1].end(),
-                      appended_branch->points_[1].cbegin() + dsize,
-                      appended_branch->points_[1].cend());
+    stype offset = num_entries();
 
-    points_[2].insert(points_[2].end(),
-                      appended_branch->points_[2].cbegin() + dsize,
-                      appended_branch->points_[2].cend());
+    for (Span span : appended_branch->spans_)
+    {
+        span.offset += offset;
+        spans_.push_back(span);
+    }
 
-    segments_.insert(segments_.end(), appended_branch->segments_.cbegin(),
-                     appended_branch->segments_.cend());
+    size_ += appended_branch->num_entries();
 
-    assert(points_[2].size() == total_size);
+    assert(size_ == total_size);
 }
 
 
@@ -295,36 +269,41 @@ void Branch::append_branch(BranchPtr appended_branch)
 // }
 
 
-PointArray Branch::get_last_point() const
-{
-    return {{points_[0].back(), points_[1].back(), points_[2].back()}};
-}
+PointArray Branch::get_last_point() const { return at(size_ - 1); }
 
 
 BPoint Branch::get_last_xy() const
 {
-    if (points_[0].size() == 0)
+    if (size_ == 0)
     {
         return initial_point_;
     }
     else
     {
-        return BPoint(points_[0].back(), points_[1].back());
+        return xy_at(size_ - 1);
     }
 }
 
 
-double Branch::initial_distance_to_soma() const { return points_[2].front(); }
+double Branch::initial_distance_to_soma() const { return first_[2]; }
 
 
-double Branch::final_distance_to_soma() const { return points_[2].back(); }
+double Branch::final_distance_to_soma() const
+{
+    if (size_ > 1)
+    {
+        return at(size_ - 1)[2];
+    }
+
+    return first_[2];
+}
 
 
 double Branch::get_length() const
 {
-    if (not points_[2].empty())
+    if (size_ > 0)
     {
-        return points_[2].back() - points_[2].front();
+        return final_distance_to_soma() - first_[2];
     }
 
     return 0.;
@@ -338,20 +317,20 @@ double Branch::get_segment_length_at(stype idx) const
         return 0;
     }
 
-    return points_.at(2).at(idx) - points_.at(2).at(idx - 1);
+    return at(idx)[2] - at(idx - 1)[2];
 }
 
 
 double Branch::get_last_segment_length() const
 {
-    if (points_[2].size() >= 2)
+    if (size_ >= 2)
     {
-        return points_.at(2).back() - points_.at(2).at(size() - 2);
+        return at(size_ - 1)[2] - at(size_ - 2)[2];
     }
-    else if (points_[2].size() == 1)
+    else if (size_ == 1)
     {
-        double dx = points_[0].back() - initial_point_.x();
-        double dy = points_[1].back() - initial_point_.y();
+        double dx = first_[0] - initial_point_.x();
+        double dy = first_[1] - initial_point_.y();
         return sqrt(dx * dx + dy * dy);
     }
 
@@ -361,45 +340,357 @@ double Branch::get_last_segment_length() const
 
 const BPolygonPtr Branch::get_last_segment() const
 {
-    if (segments_.empty())
+    return get_polygon(get_last_geometry());
+}
+
+
+/**
+ * @brief Stored geometry of the last segment, shared with the space manager
+ * (unlike the polygons of compact geometries, which are rebuilt at each call,
+ * it can be compared to the geometries of the R-tree objects).
+ */
+GeometryPtr Branch::get_last_geometry() const
+{
+    stype n = num_entries();
+
+    if (n == 0)
     {
         return nullptr;
     }
 
-    return segments_.back();
+    stype pos;
+    const Span &span = find_span(n - 1, pos);
+
+    return span.chunk->segments[pos];
 }
 
 
 const BPolygonPtr Branch::get_segment_at(stype idx) const
 {
-    return segments_.at(idx);
+    if (idx >= num_entries())
+    {
+        throw std::out_of_range("Segment " + std::to_string(idx) +
+                                " does not exist.");
+    }
+
+    return entry_segment(idx);
 }
 
 
 seg_range Branch::segment_range() const
 {
-    return boost::make_iterator_range(segments_);
+    seg_range segments;
+    segments.reserve(num_entries());
+
+    for (const Span &span : spans_)
+    {
+        for (stype i = span.begin; i < span.end; i++)
+        {
+            if (span.chunk->segments[i] != nullptr)
+            {
+                segments.push_back(get_polygon(span.chunk->segments[i]));
+            }
+        }
+    }
+
+    return segments;
+}
+
+
+std::vector<double> Branch::get_xlist() const
+{
+    std::vector<double> xlist;
+    xlist.reserve(size_);
+
+    if (size_ > 0)
+    {
+        xlist.push_back(first_[0]);
+    }
+
+    for (const Span &span : spans_)
+    {
+        for (stype i = span.begin; i < span.end; i++)
+        {
+            xlist.push_back(span.chunk->get(i)[0]);
+        }
+    }
+
+    return xlist;
 }
 
 
-const std::vector<double> &Branch::get_xlist() const { return points_.at(0); }
+std::vector<double> Branch::get_ylist() const
+{
+    std::vector<double> ylist;
+    ylist.reserve(size_);
+
+    if (size_ > 0)
+    {
+        ylist.push_back(first_[1]);
+    }
 
+    for (const Span &span : spans_)
+    {
+        for (stype i = span.begin; i < span.end; i++)
+        {
+            ylist.push_back(span.chunk->get(i)[1]);
+        }
+    }
 
-const std::vector<double> &Branch::get_ylist() const { return points_.at(1); }
+    return ylist;
+}
 
 
 PointArray Branch::at(stype idx) const
 {
-    return {{points_[0].at(idx), points_[1].at(idx), points_[2].at(idx)}};
+    if (idx >= size_)
+    {
+        throw std::out_of_range("Point " + std::to_string(idx) +
+                                " does not exist.");
+    }
+
+    if (idx == 0)
+    {
+        return first_;
+    }
+
+    stype pos;
+    const Span &span = find_span(idx - 1, pos);
+
+    return span.chunk->get(pos);
 }
 
 
 BPoint Branch::xy_at(stype idx) const
 {
-    return BPoint(points_[0].at(idx), points_[1].at(idx));
+    PointArray p = at(idx);
+
+    return BPoint(p[0], p[1]);
 }
 
 
-stype Branch::size() const { return points_[0].size(); }
+stype Branch::size() const { return size_; }
+
+
+/**
+ * @brief Number of points stored in the chunks (all but the first point).
+ */
+stype Branch::num_entries() const
+{
+    if (spans_.empty())
+    {
+        return 0;
+    }
+
+    const Span &last = spans_.back();
+
+    return last.offset + last.end - last.begin;
+}
+
+
+/**
+ * @brief Get the span containing `entry` and its position in the chunk.
+ */
+const Branch::Span &Branch::find_span(stype entry, stype &pos) const
+{
+    assert(entry < num_entries());
+
+    // most accesses are made close to the end of the branch
+    auto it = spans_.end() - 1;
+
+    if (entry < it->offset)
+    {
+        it = std::upper_bound(
+                 spans_.begin(), spans_.end(), entry,
+                 [](stype e, const Span &s) { return e < s.offset; }) -
+             1;
+    }
+
+    pos = it->begin + entry - it->offset;
+
+    return *it;
+}
+
+
+BPolygonPtr Branch::entry_segment(stype entry) const
+{
+    stype pos;
+    const Span &span = find_span(entry, pos);
+
+    return get_polygon(span.chunk->segments[pos]);
+}
+
+
+/**
+ * @brief Add a point at the end of the branch.
+ *
+ * The point goes into the last chunk if this branch owns it alone and it is
+ * not full, otherwise a new chunk is started.
+ */
+void Branch::push_entry(double x, double y, double dist, GeometryPtr geom)
+{
+    bool new_chunk = spans_.empty();
+
+    if (not new_chunk)
+    {
+        trim_last_chunk();
+
+        const Span &last = spans_.back();
+
+        new_chunk = last.chunk.use_count() > 1 or
+                    last.end >= BRANCH_CHUNK_SIZE;
+    }
+
+    if (new_chunk)
+    {
+        bool compact = kernel().space_manager.compact_geometry();
+
+        spans_.push_back({std::make_shared<Chunk>(x, y, dist, compact), 0, 0,
+                          num_entries()});
+    }
+
+    Span &last = spans_.back();
+
+    last.chunk->push_back(x, y, dist, geom);
+    last.end++;
+    size_++;
+}
+
+
+/**
+ * @brief Keep only the first `num_entries` entries (and the first point).
+ */
+void Branch::truncate(stype num_entries)
+{
+    while (not spans_.empty() and spans_.back().offset >= num_entries)
+    {
+        spans_.pop_back();
+    }
+
+    if (not spans_.empty())
+    {
+        Span &last = spans_.back();
+
+        last.end = std::min(last.end, last.begin + num_entries - last.offset);
+
+        trim_last_chunk();
+    }
+
+    size_ = num_entries + 1;
+}
+
+
+/**
+ * @brief Free the entries of the last chunk that are past the end of the
+ * branch, if no other branch uses this chunk.
+ */
+void Branch::trim_last_chunk()
+{
+    const Span &last = spans_.back();
+
+    if (last.chunk.use_count() == 1 and last.end < last.chunk->size())
+    {
+        last.chunk->resize(last.end);
+    }
+}
+
+
+/**
+ * @brief Set the last points from the vertices of the removed polygon
+ * `end_poly` which are on the new last polygon.
+ *
+ * Compact geometries rebuild each polygon from its own float offsets, so the
+ * shared vertices can be slightly off the other polygon: the two vertices
+ * closest to `last_poly` are used (in ring order).
+ */
+void Branch::update_last_points(BPolygonPtr end_poly, BPolygonPtr last_poly)
+{
+    if (end_poly == nullptr or last_poly == nullptr)
+    {
+        return;
+    }
+
+    const BRing &ring = end_poly->outer();
+
+    std::vector<std::pair<double, stype>> distances;
+
+    for (stype i = 0; i < ring.size() - 1; i++)
+    {
+        distances.push_back({bg::distance(ring[i], *(last_poly.get())), i});
+    }
+
+    assert(distances.size() >= 2);
+
+    std::partial_sort(distances.begin(), distances.begin() + 2,
+                      distances.end());
+
+    stype first  = std::min(distances[0].second, distances[1].second);
+    stype second = std::max(distances[0].second, distances[1].second);
+
+    last_points_.first  = ring[first];
+    last_points_.second = ring[second];
+}
+
+
+// Chunk
+
+Branch::Chunk::Chunk(double x, double y, double dist, bool compact_)
+    : origin({{x, y, dist}})
+    , compact(compact_)
+{
+}
+
+
+void Branch::Chunk::push_back(double x, double y, double dist,
+                              GeometryPtr geom)
+{
+    if (compact)
+    {
+        compact_values.push_back(static_cast<float>(x - origin[0]));
+        compact_values.push_back(static_cast<float>(y - origin[1]));
+        compact_values.push_back(static_cast<float>(dist - origin[2]));
+    }
+    else
+    {
+        values.push_back(x);
+        values.push_back(y);
+        values.push_back(dist);
+    }
+
+    segments.push_back(geom);
+}
+
+
+void Branch::Chunk::resize(stype n)
+{
+    if (compact)
+    {
+        compact_values.resize(3 * n);
+    }
+    else
+    {
+        values.resize(3 * n);
+    }
+
+    segments.resize(n);
+}
+
+
+stype Branch::Chunk::size() const { return segments.size(); }
+
+
+PointArray Branch::Chunk::get(stype pos) const
+{
+    stype i = 3 * pos;
+
+    if (compact)
+    {
+        return {{origin[0] + compact_values[i],
+                 origin[1] + compact_values[i + 1],
+                 origin[2] + compact_values[i + 2]}};
+    }
+
+    return {{values[i], values[i + 1], values[i + 2]}};
+}
 
 } // namespace growth
@@ -21,6 +21,7 @@
 
 // Copyright (c) 2017 Copyright Holder All Rights Reserved.
 
+#include <memory>
 #include <vector>
 
 #ifndef BRANCH_H
@@ -37,15 +38,66 @@ The Branch class is responsible for storing the spatial points representing
 the neurite in space.
 Each Branch instance is associated to a unique TopologicalNode and thus stores
 the continuous set of points that defines its trajectory over time.
+
+Points are stored in shared, append-only chunks so that copying, splitting
+(`resize_head`/`resize_tail`) or appending branches costs O(chunks) instead
+of O(points).
  */
 class Branch
 {
   private:
+    /*
+     * Block of at most BRANCH_CHUNK_SIZE consecutive points, each stored with
+     * the segment that ends on it.
+     * Chunks are shared between a branch and its copies or sub-branches:
+     * they are only modified by a branch which owns them alone.
+     *
+     * With the ``compact_geometry`` kernel parameter, new chunks store the
+     * points as float offsets from their first point (x, y and distance to
+     * soma), which halves their size. The absolute error on each value is
+     * then below 2^-24 (6e-8) times its offset, i.e. at most 6e-5 um for a
+     * chunk spanning 1 mm. The segments are then CompactGeometry objects,
+     * rebuilt as double precision polygons when they are accessed.
+     */
+    struct Chunk
+    {
+        Chunk(double x, double y, double dist, bool compact);
+
+        void push_back(double x, double y, double dist, GeometryPtr geom);
+        void resize(stype n);
+        stype size() const;
+        PointArray get(stype pos) const;
+
+        PointArray origin;
+        bool compact;
+        std::vector<double> values;        // x, y, dist of each point
+        std::vector<float> compact_values; // same, as offsets from origin
+        std::vector<GeometryPtr> segments;
+    };
+
+    //! Entries [begin, end) of a chunk, from entry `offset` of the branch
+    struct Span
+    {
+        std::shared_ptr<Chunk> chunk;
+        stype begin;
+        stype end;
+        stype offset;
+    };
+
     BPoint initial_point_;
-    PointsArray points_;
-    std::vector<BPolygonPtr> segments_;
+    PointArray first_;        // first point (x, y, distance to soma)
+    std::vector<Span> spans_; // following points (the entries)
+    stype size_;              // number of points
     std::pair<BPoint, BPoint> last_points_;
 
+    stype num_entries() const;
+    const Span &find_span(stype entry, stype &pos) const;
+    void push_entry(double x, double y, double dist, GeometryPtr geom);
+    void truncate(stype num_entries);
+    void trim_last_chunk();
+    BPolygonPtr entry_segment(stype entry) const;
+    void update_last_points(BPolygonPtr end_poly, BPolygonPtr last_poly);
+
   public:
     Branch(const Branch &copy);
     //! Create a branch with initial position and if necesary an initial length
@@ -55,7 +107,7 @@ class Branch
     Branch();
     ~Branch();
 
-    void add_point(const BPoint &pos, double length, BPolygonPtr poly,
+    void add_point(const BPoint &pos, double length, GeometryPtr geom,
                    const BPoint &lp1, const BPoint &lp2);
 
     /**
@@ -114,10 +166,11 @@ class Branch
     double get_last_segment_length() const;
     double get_length() const;
     const std::pair<BPoint, BPoint> &get_last_points() const;
-    const std::vector<double> &get_xlist() const;
-    const std::vector<double> &get_ylist() const;
+    std::vector<double> get_xlist() const;
+    std::vector<double> get_ylist() const;
     PointArray get_last_point() const;
     const BPolygonPtr get_last_segment() const;
+    GeometryPtr get_last_geometry() const;
     const BPolygonPtr get_segment_at(stype idx) const;
     seg_range segment_range() const;
     // double get_normal_direction() const;
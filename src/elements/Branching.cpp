@@ -41,7 +41,7 @@
 namespace growth
 {
 
-const Event invalid_ev(std::make_tuple(Time(), 0, std::string(""), -1, -1));
+const Event invalid_ev(std::make_tuple(Time(), 0, 0, -1, -1));
 
 
 Branching::Branching()
@@ -125,27 +125,15 @@ void Branching::set_branching_event(Event &ev, signed char ev_type,
 {
     Time ev_time = kernel().simulation_manager.get_time();
 
-    // separate duration into days, hours, minutes, seconds
-    double total_hours = std::floor(duration / 60.);
-
-    double seconds = (duration - std::floor(duration)) * 60;
-    ev_time.set_sec(ev_time.get_sec() + seconds);
-
-    unsigned char minutes = duration - 60 * total_hours;
-    ev_time.set_min(ev_time.get_min() + minutes);
-
-    stype days = total_hours / 24.;
-    ev_time.set_day(ev_time.get_day() + days);
-
-    unsigned char hours = total_hours - 24 * days;
-    ev_time.set_hour(ev_time.get_hour() + hours);
+    // event time is rounded to the closest tick
+    ev_time.update(0UL, duration);
 
     // set the informations of the event
-    auto n                   = neurite_->get_parent_neuron().lock();
-    stype neuron_gid         = n->get_gid();
-    std::string neurite_name = neurite_->get_name();
+    auto n           = neurite_->get_parent_neuron().lock();
+    stype neuron_gid = n->get_gid();
+    stype neurite_id = neurite_->get_id();
 
-    ev = std::make_tuple(ev_time, neuron_gid, neurite_name, -1, ev_type);
+    ev = std::make_tuple(ev_time, neuron_gid, neurite_id, -1, ev_type);
 }
 
 
@@ -259,14 +247,10 @@ bool Branching::branching_event(mtPtr rnd_engine, const Event &ev)
 
     if (success)
     {
-        // update the R-tree: all points from branch_point on need to be
-        // removed and reassigned to the new point.
-        int omp_id = kernel().parallelism_manager.get_thread_local_id();
-
-        kernel().space_manager.update_objects_branching(
-            branching_node, new_node, branching_point,
-            neurite_->get_parent_neuron().lock()->get_gid(),
-            neurite_->get_name(), omp_id);
+        // segments before the branching point now belong to the new node;
+        // their keys in the R-tree do not change, only the neurite's table
+        neurite_->split_segment_keys(branching_node->get_node_id(),
+                                     new_node->get_node_id(), branching_point);
 
         // for split events
         if (van_pelt_occurence or res_occurence or usplit_occurence)
@@ -323,9 +307,12 @@ void Branching::update_splitting_cones(TNodePtr branching_cone,
         bg::envelope(*(last_seg.get()), box);
 
         // the last segment is initial size - 2 i.e. new size - 1
-        ObjectInfo info = std::make_tuple(
-            neurite_->get_parent_neuron().lock()->get_gid(),
-            neurite_->get_name(), new_node->get_node_id(), branch->size() - 1);
+        stype node(new_node->get_node_id()), segment(branch->size() - 1);
+        neurite_->segment_key(node, segment);
+
+        ObjectInfo info =
+            std::make_tuple(neurite_->get_parent_neuron().lock()->get_gid(),
+                            neurite_->get_name(), node, segment);
 
         kernel().space_manager.remove_object(box, info, omp_id);
     }
@@ -367,14 +354,17 @@ void Branching::update_splitting_cones(TNodePtr branching_cone,
 
         double module = bg::distance(tmp, pos1);
 
+        // keys of the branching cone continue after those of new_node
+        stype node(branching_cone->get_node_id()), segment(0);
+        neurite_->segment_key(node, segment);
+
         try
         {
             kernel().space_manager.add_object(
                 tmp, pos1, branching_cone->get_diameter(), module,
                 neurite_->get_taper_rate(),
                 std::make_tuple(neurite_->get_parent_neuron().lock()->get_gid(),
-                                neurite_->get_name(),
-                                branching_cone->get_node_id(), 0),
+                                neurite_->get_name(), node, segment),
                 branching_cone->get_branch(), omp_id);
         }
         catch (...)
@@ -107,6 +107,7 @@ GrowthCone::GrowthCone(const std::string &model)
     , max_sensing_angle_(MAX_SENSING_ANGLE)
     , scale_up_move_(SCALE_UP_MOVE)
     , old_angle_(0.)
+    , wall_distance_(0.)
 {
     // random distributions
     normal_      = std::normal_distribution<double>(0, 1);
@@ -153,6 +154,7 @@ GrowthCone::GrowthCone(const GrowthCone &copy)
     , min_filopodia_(copy.min_filopodia_)
     , num_filopodia_(copy.num_filopodia_)
     , old_angle_(copy.old_angle_)
+    , wall_distance_(0.)
 {
     normal_  = std::normal_distribution<double>(0, 1);
     uniform_ = std::uniform_real_distribution<double>(0., 1.);
@@ -269,6 +271,9 @@ void GrowthCone::grow(mtPtr rnd_engine, stype cone_n, double substep)
         new_pos_area = std::vector<std::string>(filopodia_.size,
                                                 current_area_);
 
+        // distance to the nearest wall is unknown until we sense
+        wall_distance_ = 0.;
+
         // =================================================== //
         // Are we retracting because we were previously stuck? //
         // =================================================== //
@@ -353,7 +358,7 @@ void GrowthCone::grow(mtPtr rnd_engine, stype cone_n, double substep)
                 // check accessibility
                 kernel().space_manager.check_accessibility(
                     directions_weights, filopodia_, get_position(), move_,
-                    get_branch()->get_last_segment());
+                    get_branch()->get_last_segment(), wall_distance_);
 
                 // check for stuck/total_proba_
                 // take optional GC rigidity into account
@@ -531,8 +536,10 @@ void GrowthCone::retraction(double distance, stype cone_n, int omp_id)
         {
             box = bg::return_envelope<BBox>(*(poly.get()));
             // there is one less segment than point, so size - 2 for segment
-            info = std::make_tuple(neuron_id_, neurite_name_, get_node_id(),
-                                   branch_->size() - 2);
+            stype node(get_node_id()), segment(branch_->size() - 2);
+            own_neurite_->segment_key(node, segment);
+
+            info = std::make_tuple(neuron_id_, neurite_name_, node, segment);
         }
 
         double remaining = distance_done - distance;
@@ -687,8 +694,21 @@ bool GrowthCone::sense_surroundings(std::vector<double> &directions_weights,
                                     std::vector<bool> &wall_presence,
                                     double substep, mtPtr rnd_engine)
 {
+    ProfileTimer timer(kernel().profile_manager, profiling::SENSE);
+
     if (sensing_required_)
     {
+        // fast path: nothing within filopodia range, no intersection needed
+        bool free_space = kernel().space_manager.sense_free_space(
+            directions_weights, filopodia_, position_, move_,
+            0.5 * get_diameter(), branch_->get_last_geometry(), wall_distance_,
+            kernel().parallelism_manager.get_thread_local_id());
+
+        if (free_space)
+        {
+            return false;
+        }
+
         double up_move = scale_up_move_ == 0 ? std::nan("") : scale_up_move_;
 
         return kernel().space_manager.sense(
@@ -716,6 +736,8 @@ void GrowthCone::make_move(const std::vector<double> &directions_weights,
     assert(directions_weights.size() == filopodia_.size);
     assert(filopodia_.directions.size() == filopodia_.size);
 
+    ProfileTimer timer(kernel().profile_manager, profiling::MAKE_MOVE);
+
     double x = uniform_(*(rnd_engine).get()) * total_proba_;
 
     // check whether we're stopped
@@ -772,8 +794,9 @@ void GrowthCone::make_move(const std::vector<double> &directions_weights,
             }
 
             // set the new angle (chose a valid position if target position
-            // is outside the environment)
-            if (using_environment_)
+            // is outside the environment), no need to test if the walls are
+            // out of reach
+            if (using_environment_ and move_.module >= wall_distance_)
             {
                 if (kernel().space_manager.intersects("environment", line))
                 {
@@ -861,13 +884,16 @@ void GrowthCone::make_move(const std::vector<double> &directions_weights,
                     // send the new segment to the space manager
                     // note the size - 1 in the tuple because there is always
                     // one less segment than the number of points
+                    stype node(get_node_id()), segment(branch_->size() - 1);
+                    own_neurite_->segment_key(node, segment);
+
                     try
                     {
                         kernel().space_manager.add_object(
                             position_, p, get_diameter(), move_.module,
                             own_neurite_->get_taper_rate(),
-                            std::make_tuple(neuron_id_, neurite_name_,
-                                            get_node_id(), branch_->size() - 1),
+                            std::make_tuple(neuron_id_, neurite_name_, node,
+                                            segment),
                             branch_, omp_id);
                     }
                     catch (...)
@@ -38,6 +38,10 @@
 namespace growth
 {
 
+// forward declare the extension interface
+class ExtensionModel;
+
+
 /*
  * Growth Cone is an abstract class
  * It is a base model which is overloaded by more detailed models.
@@ -96,6 +100,7 @@ class GrowthCone : public TopologicalNode,
     double scale_up_move_;   // maximal height that GC can cross upwards
     double retraction_time_;
     double old_angle_;
+    double wall_distance_; // distance to the nearest wall (0 if unknown)
 
     space_tree_map current_neighbors_;
 
@@ -156,6 +161,7 @@ class GrowthCone : public TopologicalNode,
     virtual void compute_speed(mtPtr rnd_engine, double substep) = 0;
     virtual void update_speed(double update_factor) = 0;
     virtual double get_max_speed() = 0;
+    virtual ExtensionModel *get_elongator() const = 0;
 
     void init_filopodia();
 
@@ -26,7 +26,9 @@
 // c++ includes
 #include <algorithm>
 #include <cmath>
+#include <iterator>
 #include <memory>
+#include <mutex>
 #include <sstream>
 
 // elements includes
@@ -41,7 +43,7 @@
 // models includes
 #include "ActinWave.hpp"
 #include "Node.hpp"
-//~ #include "gc_critical.hpp"
+#include "extension_resource_based.hpp"
 #include "growth_names.hpp"
 
 // debug
@@ -49,6 +51,12 @@
 #include <typeinfo>
 
 
+// neurites with more active growth cones are grown as OpenMP tasks
+#define TASK_MIN_GROWTH_CONES 8
+// number of growth cones in each task
+#define TASK_CHUNK_SIZE 4
+
+
 namespace growth
 {
 
@@ -65,6 +73,7 @@ Neurite::Neurite(const std::string &name, const std::string &neurite_type,
     : parent_(p)
     , branching_model_(std::make_shared<Branching>())
     , name_(name)
+    , id_(0)
     , observables_(
           {"length", "speed", "num_growth_cones", "retraction_time", "status"})
     , num_created_nodes_(0)
@@ -74,6 +83,7 @@ Neurite::Neurite(const std::string &name, const std::string &neurite_type,
     , max_gc_num_(MAX_GC_NUM)
     , max_arbor_len_(MAX_ARBOR_LENGTH)
     , fixed_arbor_len_(0.)
+    , growing_in_tasks_(false)
     , initial_diameter_(NEURITE_DIAMETER)
     // parameters for van Pelt branching
     , lateral_branching_angle_mean_(LATERAL_BRANCHING_ANGLE_MEAN)
@@ -102,15 +112,8 @@ Neurite::Neurite(const std::string &name, const std::string &neurite_type,
                   0,
                   0}
 {
-    // check if the growth cone model requires resource
-    if (growth_cone_model_.find("resource-based") == 0)
-    {
-        use_critical_resource_ = true;
-    }
-    else
-    {
-        use_critical_resource_ = false;
-    }
+    // set from the elongation model of the first growth cone (see add_cone)
+    use_critical_resource_ = false;
 
     uniform_   = std::uniform_real_distribution<double>(0., 1.);
     poisson_   = std::poisson_distribution<>(0);
@@ -229,10 +232,21 @@ void Neurite::grow(mtPtr rnd_engine, stype current_step, double substep)
 
     growth_cones_tmp_.clear();
 
-    // call the branching model specific update
-    update_growth_cones(rnd_engine, substep);
+    // large neurites are grown in parallel, idle threads can steal the tasks
+    bool use_tasks = false;
+
+#ifdef WITH_OMP
+    use_tasks = kernel().simulation_manager.growth_cone_tasks() and
+                growth_cones_.size() >= TASK_MIN_GROWTH_CONES and
+                omp_in_parallel();
+#endif
 
-    // grow all the growth cones
+    if (use_tasks)
+    {
+        grow_cones_in_tasks(rnd_engine, substep);
+    }
+
+    // grow all the growth cones (or reduce the results of the tasks)
     double diameter, b_length, total_b_length(0.);
 
     for (auto &gc : growth_cones_)
@@ -244,14 +258,17 @@ void Neurite::grow(mtPtr rnd_engine, stype current_step, double substep)
         // compute and check growth cones' diameters for stop
         if (diameter > min_diameter_)
         {
-            try
+            if (not use_tasks)
             {
-                gc.second->grow(rnd_engine, gc.first, substep);
-            }
-            catch (...)
-            {
-                std::throw_with_nested(
-                    std::runtime_error("Passed from `Neurite::grow`."));
+                try
+                {
+                    gc.second->grow(rnd_engine, gc.first, substep);
+                }
+                catch (...)
+                {
+                    std::throw_with_nested(
+                        std::runtime_error("Passed from `Neurite::grow`."));
+                }
             }
 
             if (gc.second->stopped_ or gc.second->stuck_)
@@ -334,6 +351,9 @@ void Neurite::grow(mtPtr rnd_engine, stype current_step, double substep)
 
     dead_cones_.clear();
 
+    // model specific update, from the state of the growth cones which grew
+    update_growth_cones(rnd_engine, substep);
+
     // check total length
     if (fixed_arbor_len_ + total_b_length >= max_arbor_len_)
     {
@@ -342,84 +362,189 @@ void Neurite::grow(mtPtr rnd_engine, stype current_step, double substep)
 }
 
 
+/**
+ * @brief Grow the active growth cones as OpenMP tasks.
+ *
+ * Growth cones are sorted by id and split into chunks of TASK_CHUNK_SIZE,
+ * each chunk being an OpenMP task that any thread of the team can execute
+ * (threads waiting at a barrier or a taskwait pick up pending tasks).
+ * Each chunk uses its own RNG, seeded from `rnd_engine`, so the random
+ * numbers do not depend on the thread which executes the task.
+ * Growth cone deletions requested by the tasks are applied afterwards, in
+ * increasing id order; the rest of the bookkeeping (diameters, total length,
+ * inactive growth cones) is done serially by `grow`.
+ */
+void Neurite::grow_cones_in_tasks(mtPtr rnd_engine, double substep)
+{
+    std::vector<std::pair<stype, GCPtr>> cones;
+
+    for (auto &gc : growth_cones_)
+    {
+        if (gc.second->get_diameter() > min_diameter_)
+        {
+            cones.push_back(gc);
+        }
+    }
+
+    std::sort(cones.begin(), cones.end(),
+              [](const std::pair<stype, GCPtr> &lhs,
+                 const std::pair<stype, GCPtr> &rhs) {
+                  return lhs.first < rhs.first;
+              });
+
+    stype num_cones  = cones.size();
+    stype num_chunks = (num_cones + TASK_CHUNK_SIZE - 1) / TASK_CHUNK_SIZE;
+
+    std::vector<std::mt19937::result_type> seeds(num_chunks);
+
+    for (auto &seed : seeds)
+    {
+        seed = (*rnd_engine.get())();
+    }
+
+    std::once_flag exception_capture_flag;
+    std::exception_ptr captured_exception;
+
+    // tasks can be run by other threads, which see their own time otherwise
+    const Time now = kernel().simulation_manager.get_time();
+
+    growing_in_tasks_ = true;
+
+    for (stype c = 0; c < num_chunks; c++)
+    {
+#pragma omp task default(shared) firstprivate(c)
+        {
+            mtPtr chunk_rng = std::make_shared<std::mt19937>(seeds[c]);
+            stype last      = std::min(num_cones, (c + 1) * TASK_CHUNK_SIZE);
+
+            const Time *previous =
+                kernel().simulation_manager.set_task_time(&now);
+
+            for (stype i = c * TASK_CHUNK_SIZE; i < last; i++)
+            {
+                try
+                {
+                    cones[i].second->grow(chunk_rng, cones[i].first, substep);
+                }
+                catch (...)
+                {
+                    std::call_once(exception_capture_flag,
+                                   [&captured_exception]() {
+                                       captured_exception =
+                                           std::current_exception();
+                                   });
+                }
+            }
+
+            kernel().simulation_manager.set_task_time(previous);
+        }
+    }
+
+#pragma omp taskwait
+
+    growing_in_tasks_ = false;
+
+    if (captured_exception != nullptr)
+    {
+        try
+        {
+            std::rethrow_exception(captured_exception);
+        }
+        catch (...)
+        {
+            std::throw_with_nested(
+                std::runtime_error("Passed from `Neurite::grow`."));
+        }
+    }
+
+    std::sort(pending_deletions_.begin(), pending_deletions_.end());
+
+    for (stype cone_n : pending_deletions_)
+    {
+        delete_cone(cone_n);
+    }
+
+    pending_deletions_.clear();
+}
+
+
 /**
  * @brief Update the growth cones depending on their model
- * @details Each model of neurite, like critical_resource has it's own
- * parameters to update, this function will be overriden by neurite's models
+ * @details For the resource-based model, the competition between the growth
+ * cones of the neurite is computed here, once per substep: the demands of the
+ * growth cones are packed in `cr_demands_`, normalized by their sum, and the
+ * amounts received are scattered back to the extension models before they
+ * update their resource.
+ * This is called at the end of `grow`, so the step length and stuck state
+ * used by the models are those of the substep which was just grown, and the
+ * new resource sets the speed of the next substep.
  *
  * @param rnd_engine
  */
 void Neurite::update_growth_cones(mtPtr rnd_engine, double substep)
 {
-    // if using critical_resource model it's necessary to recompute the amount
-    // of critical_resource required from each growth cone.
-    //~ if (use_critical_resource_)
-    //~ {
-    //~ std::shared_ptr<GrowthCone_Critical> gcc;
-    //~ cr_neurite_.tot_demand = 0;
-
-    //~ stype i(0), j(0);
-    //~ double ministep = 0.1;
-    //~ double elapsed  = 0.;
-    //~ double norm     = 1. / substep;
-    //~ std::vector<double> avg_speed(growth_cones_.size(), 0);
-
-    //~ while (elapsed < substep)
-    //~ {
-    //~ i += 1;
-    //~ j = 0;
-
-    //~ if (elapsed + ministep > substep)
-    //~ {
-    //~ ministep = substep - elapsed;
-    //~ elapsed  = substep;
-    //~ }
-    //~ else
-    //~ {
-    //~ elapsed += ministep;
-    //~ }
-
-    //~ // compute the total demand
-    //~ for (auto &gc : growth_cones_)
-    //~ {
-    //~ gcc = std::dynamic_pointer_cast<GrowthCone_Critical>(gc.second);
-    //~ cr_neurite_.tot_demand += gcc->get_res_demand();
-    //~ }
-
-    //~ assert(cr_neurite_.tot_demand >= 0.);
-
-    //~ if (cr_neurite_.tot_demand != 0)
-    //~ {
-    //~ cr_neurite_.tot_demand = 1. / cr_neurite_.tot_demand;
-    //~ }
-
-    //~ // compute the evolution of the resource
-    //~ for (auto &gc : growth_cones_)
-    //~ {
-    //~ gcc = std::dynamic_pointer_cast<GrowthCone_Critical>(gc.second);
-    //~ gcc->compute_CR(rnd_engine, ministep);
-    //~ avg_speed[j] +=
-    //~ gcc->compute_cr_speed(rnd_engine, ministep) * ministep;
-    //~ j++;
-    //~ }
-
-    //~ // update the total resource
-    //~ cr_neurite_.available =
-    //~ cr_neurite_.available +
-    //~ ministep * (cr_neurite_.eq_cr - cr_neurite_.available) /
-    //~ cr_neurite_.tau +
-    //~ sqrt(ministep) * cr_normal_(*(rnd_engine).get());
-    //~ }
-
-    //~ // set the gcs' speed to the average value
-    //~ j = 0;
-
-    //~ for (auto &gc : growth_cones_)
-    //~ {
-    //~ gc.second->move_.speed = avg_speed[j] * norm;
-    //~ j++;
-    //~ }
-    //~ }
+    if (not use_critical_resource_)
+    {
+        return;
+    }
+
+    stype num_cones = growth_cones_.size();
+
+    cr_cones_.resize(num_cones);
+    cr_models_.resize(num_cones);
+    cr_demands_.resize(num_cones);
+
+    // pack the demands and compute the total demand
+    stype i           = 0;
+    double tot_demand = 0.;
+
+    for (auto &gc : growth_cones_)
+    {
+        GrowthCone *cone = gc.second.get();
+
+        cr_cones_[i]  = cone;
+        cr_models_[i] =
+            dynamic_cast<ResourceBasedExtensionModel *>(cone->get_elongator());
+
+        // cones which do not use the resource take no part in the competition
+        cr_demands_[i] =
+            (cr_models_[i] == nullptr)
+                ? 0.
+                : cr_models_[i]->get_res_demand(cone->get_centrifugal_order(),
+                                                cone->get_diameter());
+
+        tot_demand += cr_demands_[i];
+        i++;
+    }
+
+    assert(tot_demand >= 0.);
+
+    // store the inverse of the total demand
+    cr_neurite_.tot_demand = (tot_demand != 0) ? 1. / tot_demand : 0.;
+
+    // scatter the received resource and update the growth cones
+    double norm = get_available_cr() * cr_neurite_.tot_demand;
+
+    for (i = 0; i < num_cones; i++)
+    {
+        if (cr_models_[i] == nullptr)
+        {
+            continue;
+        }
+
+        cr_models_[i]->received_ = norm * cr_demands_[i];
+        cr_models_[i]->compute_CR(rnd_engine, substep,
+                                  cr_cones_[i]->get_module(),
+                                  cr_cones_[i]->stuck_);
+    }
+
+    // update the total resource
+    cr_neurite_.available +=
+        substep * (cr_neurite_.eq_cr - cr_neurite_.available) /
+            cr_neurite_.tau +
+        sqrt(substep) * cr_normal_(*(rnd_engine).get());
+
+    cr_neurite_.available = std::max(cr_neurite_.available, 0.);
 }
 
 
@@ -481,6 +606,18 @@ void Neurite::delete_parent_node(NodePtr parent, int living_child_id)
  */
 void Neurite::delete_cone(stype cone_n)
 {
+    // deletions change the state of the other growth cones, so they are
+    // delayed until all the tasks are done
+    if (growing_in_tasks_)
+    {
+#pragma omp critical(neurite_pending_deletions)
+        {
+            pending_deletions_.push_back(cone_n);
+        }
+
+        return;
+    }
+
     // check if not already dead (can call this function several times in a
     // single timestep)
     GCPtr dead_cone = growth_cones_[cone_n];
@@ -796,12 +933,20 @@ bool Neurite::lateral_branching(TNodePtr branching_node, stype branch_point,
 
         for (auto info : neighbors_info)
         {
-            if (std::get<ndata::NEURON>(info) == gid and
-                std::get<ndata::NEURITE>(info) == name_ and
-                std::get<ndata::NODE>(info) == nid)
+            if (std::get<ndata::NEURON>(info) != gid or
+                std::get<ndata::NEURITE>(info) != name_)
             {
-                stype seg_id = std::get<ndata::SEGMENT>(info);
+                continue;
+            }
+
+            // get the current position of the segment from its key
+            stype node_id = std::get<ndata::NODE>(info);
+            stype seg_id  = std::get<ndata::SEGMENT>(info);
 
+            segment_position(node_id, seg_id);
+
+            if (node_id == nid)
+            {
                 // check if the segment still exists (the gc may be retracting
                 // just next to the branching point)
                 if (seg_id + 1 < branch->size())
@@ -1017,6 +1162,11 @@ void Neurite::add_cone(GCPtr cone)
     if (num_created_nodes_ == 1)
     {
         growth_cones_[num_created_nodes_] = cone;
+
+        // the model name can be an alias, so check the extension model that
+        // was actually created to know if the resource is required
+        use_critical_resource_ = dynamic_cast<ResourceBasedExtensionModel *>(
+                                     cone->get_elongator()) != nullptr;
     }
     else
     {
@@ -1209,6 +1359,9 @@ NeuronWeakPtr Neurite::get_parent_neuron() const { return parent_; }
 const std::string &Neurite::get_name() const { return name_; }
 
 
+stype Neurite::get_id() const { return id_; }
+
+
 const std::string &Neurite::get_type() const { return neurite_type_; }
 
 
@@ -1237,6 +1390,67 @@ void Neurite::get_distances(stype node, stype segment, double &dist_to_parent,
 }
 
 
+/**
+ * @brief Convert the position of a segment (node id and index on the node's
+ * branch) into its key in the spatial index.
+ *
+ * Keys are set when the segment is created and never change, so branching
+ * does not modify the spatial index: segments that are moved to a new node
+ * keep the key of the node they were created on, and the keys of a node
+ * whose branch was split start with an offset.
+ */
+void Neurite::segment_key(stype &node, stype &segment) const
+{
+    auto it = segment_keys_.find(node);
+
+    if (it != segment_keys_.end())
+    {
+        node     = it->second.first;
+        segment += it->second.second;
+    }
+}
+
+
+/**
+ * @brief Convert a key from the spatial index into the current position of
+ * the segment (node id and index on the node's branch).
+ */
+void Neurite::segment_position(stype &node, stype &segment) const
+{
+    auto it = key_ranges_.find(node);
+
+    if (it != key_ranges_.end())
+    {
+        // last range starting at or before the segment key
+        auto range = std::prev(it->second.upper_bound(segment));
+
+        node     = range->second;
+        segment -= range->first;
+    }
+}
+
+
+/**
+ * @brief Update the keys after the branch of `old_node` was split at
+ * `branching_point`: the segments before it now belong to `new_node`.
+ */
+void Neurite::split_segment_keys(stype old_node, stype new_node,
+                                 stype branching_point)
+{
+    stype key_node(old_node), offset(0);
+    segment_key(key_node, offset);
+
+    std::map<stype, stype> &ranges = key_ranges_[key_node];
+
+    ranges[offset]                   = new_node;
+    ranges[offset + branching_point] = old_node;
+
+    segment_keys_[new_node] = std::make_pair(key_node, offset);
+    segment_keys_[old_node] =
+        std::make_pair(key_node, offset + branching_point);
+}
+
+
 void Neurite::update_initial_diameter(double diameter)
 {
     initial_diameter_ = diameter;
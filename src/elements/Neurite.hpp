@@ -24,8 +24,10 @@
 
 // c++ includes
 #include <deque>
+#include <map>
 #include <random>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <boost/range/iterator_range.hpp>
@@ -53,6 +55,7 @@ typedef boost::range::joined_range<const gc_map, const gc_map> joined_gc_range;
 class GrowthConeContinuousRecorder;
 class Branching;
 class Neuron;
+class ResourceBasedExtensionModel;
 
 
 typedef struct res_Neurite
@@ -102,6 +105,7 @@ class Neurite : public std::enable_shared_from_this<Neurite>
     void update_growth_cones(mtPtr rnd_engine, double substep);
     void update_resource(mtPtr rnd_engine, double substep);
     void grow(mtPtr rnd_engine, stype current_step, double substep);
+    void grow_cones_in_tasks(mtPtr rnd_engine, double substep);
     void delete_cone(stype cone_n);
 
     // critical resource
@@ -132,6 +136,12 @@ class Neurite : public std::enable_shared_from_this<Neurite>
     void get_distances(stype node, stype segment, double &dist_to_parent,
                        double &dist_to_soma) const;
 
+    // stable segment keys in the spatial index
+    void segment_key(stype &node, stype &segment) const;
+    void segment_position(stype &node, stype &segment) const;
+    void split_segment_keys(stype old_node, stype new_node,
+                            stype branching_point);
+
     //@TODO
     void update_actin_waves(mtPtr rnd_engine, double substep);
     void start_actin_wave(double actin_content);
@@ -148,6 +158,7 @@ class Neurite : public std::enable_shared_from_this<Neurite>
     NodePtr get_first_node() const;
     NeuronWeakPtr get_parent_neuron() const;
     const std::string &get_name() const;
+    stype get_id() const;
     double get_taper_rate() const;
     double get_max_resol() const;
 
@@ -169,6 +180,7 @@ class Neurite : public std::enable_shared_from_this<Neurite>
     NeuronWeakPtr parent_;
     BranchingPtr branching_model_;
     std::string name_;
+    stype id_; // index of the neurite in its neuron (unique, never reused)
     bool active_;
     double max_arbor_len_;
     double fixed_arbor_len_;
@@ -192,9 +204,16 @@ class Neurite : public std::enable_shared_from_this<Neurite>
     gc_map growth_cones_inactive_tmp_;
 
     std::vector<stype> dead_cones_;
+    // deletions requested while the growth cones are grown as tasks
+    bool growing_in_tasks_;
+    std::vector<stype> pending_deletions_;
     std::deque<ActinPtr> actinDeck_;
     std::unordered_map<stype, NodePtr> nodes_;
     std::vector<stype> dead_nodes_;
+    // nodes whose branch was split by branching: (key node, key of the
+    // first segment); ranges of keys of a key node: {first key: node id}
+    std::unordered_map<stype, std::pair<stype, stype>> segment_keys_;
+    std::unordered_map<stype, std::map<stype, stype>> key_ranges_;
     stype max_gc_num_;
 
     //! declare the type of neurite (dendrite or axon)
@@ -207,6 +226,10 @@ class Neurite : public std::enable_shared_from_this<Neurite>
     // competition
     bool use_critical_resource_;
     res_Neurite cr_neurite_;
+    // packed growth cone data for the resource-based competition
+    std::vector<GrowthCone *> cr_cones_;
+    std::vector<ResourceBasedExtensionModel *> cr_models_;
+    std::vector<double> cr_demands_;
 
     //! branch direction parameters
     double diameter_ratio_avg_;
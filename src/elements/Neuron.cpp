@@ -58,6 +58,7 @@ namespace growth
 Neuron::Neuron(stype gid)
     : gid_(gid)
     , description_("standard_neuron")
+    , num_created_neurites_(0)
     , soma_radius_(SOMA_RADIUS)
     , observables_(
           {"length", "speed", "num_growth_cones", "retraction_time", "stopped"})
@@ -96,6 +97,7 @@ Neuron::~Neuron()
     }
 
     neurites_.clear();
+    neurite_names_.clear();
 }
 
 
@@ -402,8 +404,13 @@ void Neuron::grow(mtPtr rnd_engine, stype current_step, double substep)
  */
 bool Neuron::branch(mtPtr rnd_engine, const Event &ev)
 {
-    std::string name_neurite = std::get<edata::NEURITE>(ev);
-    NeuritePtr neurite       = neurites_[name_neurite];
+    NeuritePtr neurite = get_neurite_from_id(std::get<edata::NEURITE>(ev));
+
+    // the neurite was deleted after the event was scheduled
+    if (neurite == nullptr)
+    {
+        return false;
+    }
 
     try
     {
@@ -441,6 +448,9 @@ std::string Neuron::new_neurite(const std::string &name,
         {name, std::make_shared<Neurite>(name, neurite_type, growth_cone_model_,
                                          my_weak_ptr)});
 
+    neurites_[name]->id_ = num_created_neurites_;
+    neurite_names_[num_created_neurites_++] = name;
+
     //#####################################
     // add first growth cone to the neurite
     //#####################################
@@ -663,6 +673,7 @@ void Neuron::delete_neurites(const std::vector<std::string> &names)
     if (names.empty())
     {
         neurites_.clear();
+        neurite_names_.clear();
         has_axon_ = false;
     }
     else
@@ -684,6 +695,7 @@ void Neuron::delete_neurites(const std::vector<std::string> &names)
                 neurite->growth_cones_inactive_tmp_.clear();
 
                 // remove from neurites
+                neurite_names_.erase(neurite->get_id());
                 neurites_.erase(it);
 
                 if (neurite_name == "axon")
@@ -984,4 +996,20 @@ NeuriteWeakPtr Neuron::get_neurite(const std::string &name) const
     return NeuriteWeakPtr(neurites_.at(name));
 }
 
+
+/**
+ * @brief Neurite with id `neurite_id`, nullptr if it was deleted.
+ */
+NeuritePtr Neuron::get_neurite_from_id(stype neurite_id) const
+{
+    auto it = neurite_names_.find(neurite_id);
+
+    if (it == neurite_names_.end())
+    {
+        return nullptr;
+    }
+
+    return neurites_.at(it->second);
+}
+
 } // namespace growth
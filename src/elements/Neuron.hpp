@@ -30,6 +30,7 @@
 #include <memory>
 #include <random>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 // elements includes
@@ -102,6 +103,7 @@ class Neuron : public std::enable_shared_from_this<Neuron>
     stype get_gid() const;
     std::string get_gc_model() const;
     NeuriteWeakPtr get_neurite(const std::string &name) const;
+    NeuritePtr get_neurite_from_id(stype neurite_id) const;
     double get_state(const std::string &observable) const;
     double get_state(const std::string &observable,
                      std::string &unit) const;
@@ -138,6 +140,9 @@ class Neuron : public std::enable_shared_from_this<Neuron>
     std::string description_;
     //! Container for the ``NeuritePtr`` objects
     NeuriteMap neurites_;
+    stype num_created_neurites_; // to set the neurite ids
+    //! Names of the neurites, indexed by their id
+    std::unordered_map<stype, std::string> neurite_names_;
     BaseNodePtr soma_;
     bool has_axon_;
     double soma_radius_;
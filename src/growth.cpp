@@ -54,12 +54,11 @@ int main(int argc, char **argv)
     mainMap.insert(
         {"speed_growth_cone", growth::Property(20., "micrometer / minute")});
 
-    vector<growth::statusMap> emptyMap = vector<growth::statusMap>(num_neurons);
-    unordered_map<string, vector<growth::statusMap>> mock;
-    vector<growth::statusMap> mainVec =
-        vector<growth::statusMap>(num_neurons, mainMap);
+    unordered_map<string, growth::StatusTable> mock;
+    growth::StatusTable mainTable(num_neurons);
+    mainTable.set_common(mainMap);
 
-    growth::create_neurons_(mainVec, mock);
+    growth::create_neurons_(mainTable, mock);
 
     growth::simulate_(growth::Time(200, 0, 0, 0));
 
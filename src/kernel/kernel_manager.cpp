@@ -35,6 +35,7 @@
 #include "models_manager.hpp"
 
 // spatial include
+#include "DistanceField.hpp"
 #include "Environment.hpp"
 
 
@@ -84,6 +85,7 @@ KernelManager::KernelManager()
     , record_manager()
     , model_manager()
     , neuron_manager()
+    , profile_manager()
     // status
     , initialized_(false)
     // settings
@@ -111,6 +113,7 @@ void KernelManager::initialize()
 
     // then RNG
     rng_manager.initialize();
+    profile_manager.initialize();
 
     // then the rest
     simulation_manager.initialize();
@@ -133,6 +136,7 @@ void KernelManager::finalize()
     record_manager.finalize();
     space_manager.finalize();
     simulation_manager.finalize();
+    profile_manager.finalize();
     rng_manager.finalize();
     parallelism_manager.finalize();
 
@@ -172,6 +176,7 @@ const statusMap KernelManager::get_status() const
     rng_manager.get_status(status);
     space_manager.get_status(status);
     simulation_manager.get_status(status);
+    profile_manager.get_status(status);
 
     return status;
 }
@@ -242,6 +247,7 @@ void KernelManager::set_status(const statusMap &status)
     space_manager.set_status(status);
     double old_resol = simulation_manager.get_resolution();
     simulation_manager.set_status(status);
+    profile_manager.set_status(status);
 
     // update the objects
     env_updated *= (env_required_old != env_required_);
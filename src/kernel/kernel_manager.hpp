@@ -34,6 +34,7 @@
 #include "models_manager.hpp"
 #include "neuron_manager.hpp"
 #include "parallelism_manager.hpp"
+#include "profile_manager.hpp"
 #include "record_manager.hpp"
 #include "rng_manager.hpp"
 #include "simulation_manager.hpp"
@@ -115,6 +116,7 @@ class KernelManager
     RecordManager record_manager;
     ModelManager model_manager;
     NeuronManager neuron_manager;
+    ProfileManager profile_manager;
 
   private:
     statusMap config_;  //!< configuration properties
@@ -21,13 +21,16 @@
 
 #include "neuron_manager.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <cstring>
 #include <limits>
 #include <mutex>
+#include <unordered_set>
 
 #include "config.hpp"
 #include "config_impl.hpp"
+#include "exceptions.hpp"
 #include "kernel_manager.hpp"
 
 #include "Neuron.hpp"
@@ -82,6 +85,10 @@ void NeuronManager::finalize()
 {
     neurons_.clear();
     neurons_on_thread_.clear();
+    thread_of_neuron_.clear();
+    index_on_thread_.clear();
+    num_removed_.clear();
+    sorted_end_.clear();
     model_map_.clear();
     num_created_neurons_ = 0;
 }
@@ -93,38 +100,37 @@ void NeuronManager::finalize()
  * @return Number of objects created.
  */
 stype NeuronManager::create_neurons(
-    const std::vector<statusMap> &neuron_params,
-    const std::unordered_map<std::string, std::vector<statusMap>> &neurite_params)
+    const StatusTable &neuron_params,
+    const std::unordered_map<std::string, StatusTable> &neurite_params)
 {
-    stype first_id             = kernel().get_num_created_objects();
-    stype previous_num_neurons = neurons_.size();
+    stype first_id    = kernel().get_num_created_objects();
+    stype num_neurons = neuron_params.size();
 
     // put the neurons on the thread list they belong to
     stype num_omp = kernel().parallelism_manager.get_num_local_threads();
-    int omp_id    = kernel().parallelism_manager.get_thread_local_id();
     std::vector<std::vector<stype>> thread_neurons(num_omp);
 
-    for (stype i = 0; i < neuron_params.size(); i++)
+    for (auto &gids : thread_neurons)
     {
-        double x, y;
-        get_param(neuron_params[i], "x", x);
-        get_param(neuron_params[i], "y", y);
+        gids.reserve(num_neurons / num_omp + 1);
+    }
 
-        if (kernel().space_manager.has_environment())
-        {
-            // printf("check point %f, %f in the environment \n",x,y);
-            if (not kernel().space_manager.env_contains(BPoint(x, y)))
-            {
-                throw std::runtime_error(
-                    "A neuron was positioned out of the environment\n");
-            }
-        }
+    // register the gids beforehand, so that the threads only have to set the
+    // value of existing entries, which does not require synchronization
+    neurons_.reserve(neurons_.size() + num_neurons);
+    thread_of_neuron_.reserve(thread_of_neuron_.size() + num_neurons);
+    index_on_thread_.reserve(index_on_thread_.size() + num_neurons);
 
+    for (stype i = 0; i < num_neurons; i++)
+    {
         // @TODO change temporary round-robin for neuron assignement
         int omp_id      = (first_id + i) % num_omp;
         stype neuron_id = first_id + i;
+
         thread_neurons[omp_id].push_back(neuron_id);
         thread_of_neuron_[neuron_id] = omp_id;
+        index_on_thread_[neuron_id]  = 0;
+        neurons_[neuron_id]          = nullptr;
     }
 
     // exception_capture_flag "guards" captured_exception. std::called_once()
@@ -141,25 +147,71 @@ stype NeuronManager::create_neurons(
 // create the neurons on the respective threads
 #pragma omp parallel
     {
-        std::vector<NeuronPtr> local_neurons;
         int omp_id       = kernel().parallelism_manager.get_thread_local_id();
         mtPtr rnd_engine = kernel().rng_manager.get_rng(omp_id);
-        std::vector<stype> gids(thread_neurons[omp_id]);
+        const std::vector<stype> &gids = thread_neurons[omp_id];
+
+        // statuses are prepared once, then only the varying entries are
+        // updated for each neuron
+        statusMap neuron_status;
+        std::vector<Property *> neuron_slots;
         std::unordered_map<std::string, statusMap> neurite_status;
+        std::vector<std::pair<const StatusTable *, std::vector<Property *>>>
+            neurite_slots;
+
+        neuron_params.prepare(neuron_status, neuron_slots);
+
+        for (const auto &entry : neurite_params)
+        {
+            neurite_slots.push_back({&entry.second, {}});
+            entry.second.prepare(neurite_status[entry.first],
+                                 neurite_slots.back().second);
+        }
+
+        std::vector<NeuronPtr> local_neurons;
+        local_neurons.reserve(gids.size());
 
         for (stype gid : gids)
         {
             stype idx        = gid - first_id;
             NeuronPtr neuron = std::make_shared<Neuron>(gid);
 
-            for (auto entry : neurite_params)
+            neuron_params.fill(idx, neuron_slots);
+
+            for (const auto &slots : neurite_slots)
             {
-                neurite_status[entry.first] = entry.second[idx];
+                slots.first->fill(idx, slots.second);
             }
 
             try
             {
-                neuron->init_status(neuron_params[idx], neurite_status,
+                double x = std::nan(""), y = std::nan("");
+
+                bool has_position = get_param(neuron_status, "x", x);
+                has_position = get_param(neuron_status, "y", y) and
+                               has_position;
+
+                if (not has_position)
+                {
+                    throw InvalidParameter("Position was not set.",
+                                           __FUNCTION__, __FILE__, __LINE__);
+                }
+
+                if (not std::isfinite(x) or not std::isfinite(y))
+                {
+                    throw std::runtime_error(
+                        "A neuron position is not finite: (" +
+                        std::to_string(x) + ", " + std::to_string(y) + ")\n");
+                }
+
+                if (kernel().space_manager.has_environment() and
+                    not kernel().space_manager.env_contains(BPoint(x, y)))
+                {
+                    throw std::runtime_error(
+                        "A neuron was positioned out of the environment\n");
+                }
+
+                neuron->init_status(neuron_status, neurite_status,
                                     rnd_engine);
 
                 // inside try to avoid pushing invalid neurons
@@ -175,16 +227,26 @@ stype NeuronManager::create_neurons(
 
 #pragma omp barrier
 
-#pragma omp critical
+        // add neurons only if no error occured; each thread only writes the
+        // values of its own entries and its own neuron list
+        if (captured_exception == nullptr)
         {
-            // add neurons only if no error occured
-            if (captured_exception == nullptr)
+            std::vector<NeuronPtr> &thread_list = neurons_on_thread_[omp_id];
+            thread_list.reserve(thread_list.size() + gids.size());
+
+            // new gids are larger than the existing ones
+            bool sorted = (sorted_end_[omp_id] == thread_list.size());
+
+            for (stype i = 0; i < gids.size(); i++)
             {
-                for (stype i = 0; i < gids.size(); i++)
-                {
-                    neurons_.insert({gids[i], local_neurons[i]});
-                    neurons_on_thread_[omp_id].push_back(local_neurons[i]);
-                }
+                neurons_.find(gids[i])->second         = local_neurons[i];
+                index_on_thread_.find(gids[i])->second = thread_list.size();
+                thread_list.push_back(local_neurons[i]);
+            }
+
+            if (sorted)
+            {
+                sorted_end_[omp_id] = thread_list.size();
             }
         }
     }
@@ -192,52 +254,132 @@ stype NeuronManager::create_neurons(
     // check if an exception was thrown there
     if (captured_exception != nullptr)
     {
+        // unregister the gids
+        for (stype i = 0; i < num_neurons; i++)
+        {
+            neurons_.erase(first_id + i);
+            thread_of_neuron_.erase(first_id + i);
+            index_on_thread_.erase(first_id + i);
+        }
+
         // rethrowing nullptr is illegal
         std::rethrow_exception(captured_exception);
     }
 
     // tell the kernel manager to update the number of objects
-    stype num_created = neurons_.size() - previous_num_neurons;
+    kernel().update_num_objects(num_neurons);
 
-    kernel().update_num_objects(num_created);
-
-    return num_created;
+    return num_neurons;
 }
 
 
+/**
+ * @brief Delete neurons.
+ *
+ * Each deleted neuron leaves a nullptr in its thread list, found through
+ * `index_on_thread_`, so that the deletion does not depend on the number of
+ * neurons. The lists are compacted before they are iterated again (see
+ * compact_thread_lists).
+ * Their segments, pending events and recorders must be removed beforehand
+ * (see ``delete_neurons_`` in module.cpp).
+ */
 void NeuronManager::delete_neurons(const std::vector<stype> &gids)
 {
-    for (stype neuron : gids)
+    for (stype gid : gids)
     {
-        auto it = neurons_.find(neuron);
-
-        NeuronPtr n = neurons_[neuron];
+        auto it = neurons_.find(gid);
 
         if (it != neurons_.end())
         {
-            for (auto v : neurons_on_thread_)
-            {
-                for (stype i = 0; i < v.size(); i++)
-                {
-                    if (v[i] == n)
-                    {
-                        v.erase(v.begin() + i);
-                        break;
-                    }
-                }
-            }
+            int omp_id = thread_of_neuron_.at(gid);
+
+            neurons_on_thread_[omp_id][index_on_thread_.at(gid)] = nullptr;
+            num_removed_[omp_id]++;
+
+            max_resolutions_[omp_id].erase(gid);
 
-            thread_of_neuron_.erase(neuron);
+            index_on_thread_.erase(gid);
+            thread_of_neuron_.erase(gid);
             neurons_.erase(it);
         }
     }
 }
 
 
+/**
+ * @brief Remove the deleted entries of the thread lists and sort them by gid.
+ *
+ * The order of the neurons on a thread is part of the deterministic update
+ * order, so this must be called before the lists are iterated after
+ * deletions or migrations. The freed slots are reused by the neurons
+ * which follow them and by the next neurons created on the thread.
+ */
+void NeuronManager::compact_thread_lists()
+{
+    for (stype i = 0; i < neurons_on_thread_.size(); i++)
+    {
+        if (num_removed_[i] > 0 or
+            sorted_end_[i] < neurons_on_thread_[i].size())
+        {
+            compact_thread_list_(i);
+        }
+    }
+}
+
+
+void NeuronManager::compact_thread_list_(int omp_id)
+{
+    std::vector<NeuronPtr> &thread_list = neurons_on_thread_[omp_id];
+
+    // remove the nullptr entries, keeping track of the sorted part
+    stype num_kept   = 0;
+    stype sorted_end = 0;
+
+    for (stype i = 0; i < thread_list.size(); i++)
+    {
+        if (i == sorted_end_[omp_id])
+        {
+            sorted_end = num_kept;
+        }
+
+        if (thread_list[i] != nullptr)
+        {
+            thread_list[num_kept++] = std::move(thread_list[i]);
+        }
+    }
+
+    if (sorted_end_[omp_id] == thread_list.size())
+    {
+        sorted_end = num_kept;
+    }
+
+    thread_list.resize(num_kept);
+
+    // sort the neurons moved to this thread and merge them with the others
+    auto less_gid = [](const NeuronPtr &lhs, const NeuronPtr &rhs) {
+        return lhs->get_gid() < rhs->get_gid();
+    };
+
+    std::sort(thread_list.begin() + sorted_end, thread_list.end(), less_gid);
+    std::inplace_merge(thread_list.begin(), thread_list.begin() + sorted_end,
+                       thread_list.end(), less_gid);
+
+    for (stype i = 0; i < num_kept; i++)
+    {
+        index_on_thread_[thread_list[i]->get_gid()] = i;
+    }
+
+    num_removed_[omp_id] = 0;
+    sorted_end_[omp_id]  = num_kept;
+}
+
+
 void NeuronManager::init_neurons_on_thread(unsigned int num_local_threads)
 {
     assert(neurons_.size() == 0); // no changes once neurons exist
     neurons_on_thread_ = std::vector<std::vector<NeuronPtr>>(num_local_threads);
+    num_removed_       = std::vector<stype>(num_local_threads, 0);
+    sorted_end_        = std::vector<stype>(num_local_threads, 0);
     max_resolutions_   = std::vector<std::unordered_map<stype, double>>(
         num_local_threads, std::unordered_map<stype, double>());
 }
@@ -256,17 +398,17 @@ void NeuronManager::update_kernel_variables()
     // the OpenMP parallel region.
     std::exception_ptr captured_exception;
 
+    compact_thread_lists();
+
 #pragma omp parallel
     {
         try
         {
             int omp_id = kernel().parallelism_manager.get_thread_local_id();
 
-            gidNeuronMap local_neurons = get_local_neurons(omp_id);
-
-            for (auto &neuron : local_neurons)
+            for (const auto &neuron : neurons_on_thread_[omp_id])
             {
-                neuron.second->update_kernel_variables();
+                neuron->update_kernel_variables();
             }
         }
         catch (const std::exception &except)
@@ -288,19 +430,48 @@ void NeuronManager::update_kernel_variables()
 
 // getters
 
-NeuronPtr NeuronManager::get_neuron(stype gid) { return neurons_[gid]; }
+/**
+ * @brief Neuron with id `gid`, nullptr if it does not exist (anymore).
+ */
+NeuronPtr NeuronManager::get_neuron(stype gid)
+{
+    auto it = neurons_.find(gid);
+
+    return it == neurons_.end() ? nullptr : it->second;
+}
 
 
-gidNeuronMap NeuronManager::get_local_neurons(int local_thread_id)
+/**
+ * @brief Neurons on a thread.
+ *
+ * The reference stays valid as long as the number of threads does not
+ * change; its content is only modified by neuron creation, deletion or
+ * load balancing.
+ * After deletions or migrations, it contains nullptr entries and is not
+ * sorted until compact_thread_lists is called (at the start of simulate
+ * and after each load balancing).
+ */
+const std::vector<NeuronPtr> &
+NeuronManager::get_local_neurons(int local_thread_id) const
 {
-    gidNeuronMap local_neurons;
+    return neurons_on_thread_[local_thread_id];
+}
+
 
-    for (auto &n : neurons_on_thread_[local_thread_id])
+/**
+ * @brief Non-owning pointer to a neuron if it is on thread `local_thread_id`,
+ * nullptr otherwise.
+ */
+Neuron *NeuronManager::get_local_neuron(stype gid, int local_thread_id) const
+{
+    auto it = thread_of_neuron_.find(gid);
+
+    if (it != thread_of_neuron_.end() and it->second == local_thread_id)
     {
-        local_neurons[n->get_gid()] = n;
+        return neurons_.at(gid).get();
     }
 
-    return local_neurons;
+    return nullptr;
 }
 
 
@@ -410,6 +581,43 @@ int NeuronManager::get_neuron_thread(stype gid) const
 }
 
 
+/**
+ * @brief Move a neuron to another OpenMP thread.
+ *
+ * Must only be called between two steps (outside of growth), when the
+ * thread-local buffers of the space manager are empty. Recorders do not
+ * depend on the neuron thread and pending events are moved by the
+ * simulation manager, so only the thread lists need to be updated.
+ * The lists must then be compacted with compact_thread_lists.
+ */
+void NeuronManager::move_neuron(stype gid, int omp_id)
+{
+    int old_id = thread_of_neuron_.at(gid);
+
+    if (old_id != omp_id)
+    {
+        stype &idx = index_on_thread_.at(gid);
+
+        // the lists are sorted by gid again by compact_thread_lists
+        neurons_on_thread_[old_id][idx] = nullptr;
+        num_removed_[old_id]++;
+
+        idx = neurons_on_thread_[omp_id].size();
+        neurons_on_thread_[omp_id].push_back(neurons_.at(gid));
+
+        thread_of_neuron_[gid] = omp_id;
+
+        auto it = max_resolutions_[old_id].find(gid);
+
+        if (it != max_resolutions_[old_id].end())
+        {
+            max_resolutions_[omp_id][gid] = it->second;
+            max_resolutions_[old_id].erase(it);
+        }
+    }
+}
+
+
 void NeuronManager::register_model(std::string model_name, GCPtr model_ptr)
 {
     model_map_[model_name] = model_ptr;
@@ -24,6 +24,7 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "config.hpp"
 #include "elements_types.hpp"
@@ -35,6 +36,7 @@ namespace growth
 // typedefs
 typedef std::unordered_map<stype, NeuronPtr> gidNeuronMap;
 typedef std::unordered_map<stype, int> gidThreadMap;
+typedef std::unordered_map<stype, stype> gidIndexMap;
 typedef std::unordered_map<std::string, GCPtr> modelMap;
 typedef std::vector<std::vector<NeuronPtr>> threadNeurons;
 
@@ -56,17 +58,19 @@ class NeuronManager : public ManagerInterface
      * Create neurons.
      */
     stype create_neurons(
-        const std::vector<statusMap> &neuron_params,
-        const std::unordered_map<std::string,
-                                 std::vector<statusMap>> &neurite_params);
+        const StatusTable &neuron_params,
+        const std::unordered_map<std::string, StatusTable> &neurite_params);
 
     void delete_neurons(const std::vector<stype> &gids);
 
     NeuronPtr get_neuron(stype gid);
     void get_all_neurons(std::vector<NeuronPtr> &);
     std::vector<stype> get_gids() const;
-    gidNeuronMap get_local_neurons(int local_thread_id);
+    const std::vector<NeuronPtr> &get_local_neurons(int local_thread_id) const;
+    Neuron *get_local_neuron(stype gid, int local_thread_id) const;
     int get_neuron_thread(stype gid) const;
+    void move_neuron(stype gid, int omp_id);
+    void compact_thread_lists();
 
     void init_neurons_on_thread(unsigned int num_local_threads);
     void update_kernel_variables();
@@ -91,11 +95,16 @@ class NeuronManager : public ManagerInterface
     modelMap model_map_;
 
   private:
+    void compact_thread_list_(int omp_id);
+
     stype num_created_neurons_;
     NeuronPtr model_neuron_;          // unused model neuron for get_defaults
     gidNeuronMap neurons_;            // get neuron from gid
-    threadNeurons neurons_on_thread_; // group neurons by thread
+    threadNeurons neurons_on_thread_; // group neurons by thread (sorted)
     gidThreadMap thread_of_neuron_;   // get thread from gid
+    gidIndexMap index_on_thread_;     // position in the thread list
+    std::vector<stype> num_removed_;  // nullptr entries in each thread list
+    std::vector<stype> sorted_end_;   // end of the sorted part of each list
     std::vector<std::unordered_map<stype, double>>
         max_resolutions_; // max allowed resol
 };
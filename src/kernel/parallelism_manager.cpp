@@ -108,6 +108,7 @@ void ParallelismManager::set_num_local_threads(int n_threads)
     kernel().simulation_manager.num_threads_changed(n_threads);
     kernel().neuron_manager.init_neurons_on_thread(n_threads);
     kernel().record_manager.num_threads_changed(n_threads);
+    kernel().profile_manager.num_threads_changed(n_threads);
 
 #ifdef WITH_OMP
     omp_set_num_threads(n_threads);
@@ -0,0 +1,160 @@
+/*
+ * profile_manager.cpp
+ *
+ * This file is part of DeNSE.
+ *
+ * Copyright (C) 2019 SeNEC Initiative
+ *
+ * DeNSE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * DeNSE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DeNSE. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "profile_manager.hpp"
+
+// C++ includes
+#include <algorithm>
+#include <cstring>
+
+// kernel includes
+#include "kernel_manager.hpp"
+
+// lib includes
+#include "growth_names.hpp"
+
+
+namespace growth
+{
+
+static const char *phase_names[profiling::NUM_PHASES] = {
+    "grow",         "sense",     "make_move", "add_object",
+    "update_rtree", "branching", "record",    "barrier"};
+
+static const char *counter_names[profiling::NUM_COUNTERS] = {
+    "steps",         "events",   "rtree_queries",
+    "intersections", "polygons", "migrations"};
+
+
+ProfileManager::ProfileManager()
+    : enabled_(false)
+{
+}
+
+
+void ProfileManager::initialize()
+{
+    enabled_ = false;
+
+    num_threads_changed(kernel().parallelism_manager.get_num_local_threads());
+}
+
+
+void ProfileManager::finalize()
+{
+    threads_.clear();
+    profile_.clear();
+}
+
+
+void ProfileManager::num_threads_changed(int num_omp)
+{
+    threads_ = std::vector<ThreadProfile>(num_omp);
+
+    for (auto &tp : threads_)
+    {
+        std::memset(&tp, 0, sizeof(ThreadProfile));
+    }
+}
+
+
+/**
+ * @brief Reset the thread values at the beginning of `simulate`.
+ */
+void ProfileManager::start_simulation()
+{
+    if (enabled_)
+    {
+        num_threads_changed(
+            kernel().parallelism_manager.get_num_local_threads());
+
+        sim_start_ = std::chrono::steady_clock::now();
+    }
+}
+
+
+/**
+ * @brief Aggregate the thread values at the end of `simulate`.
+ *
+ * Times are summed over the threads (``<phase>_time``), the maximum over
+ * the threads is also given (``<phase>_max_time``) to assess load imbalance.
+ */
+void ProfileManager::finalize_simulation()
+{
+    if (not enabled_)
+    {
+        return;
+    }
+
+    std::chrono::duration<double> wall_time =
+        std::chrono::steady_clock::now() - sim_start_;
+
+    profile_.clear();
+
+    profile_["wall_time"]   = wall_time.count();
+    profile_["num_threads"] = threads_.size();
+
+    for (int i = 0; i < profiling::NUM_PHASES; i++)
+    {
+        std::string name(phase_names[i]);
+
+        double total(0.), tmax(0.);
+        stype calls(0);
+
+        for (const auto &tp : threads_)
+        {
+            total += tp.time[i];
+            tmax   = std::max(tmax, tp.time[i]);
+            calls += tp.calls[i];
+        }
+
+        profile_[name + "_time"]     = total;
+        profile_[name + "_max_time"] = tmax;
+        profile_[name + "_calls"]    = calls;
+    }
+
+    for (int i = 0; i < profiling::NUM_COUNTERS; i++)
+    {
+        stype total = 0;
+
+        for (const auto &tp : threads_)
+        {
+            total += tp.counts[i];
+        }
+
+        profile_[counter_names[i]] = total;
+    }
+}
+
+
+void ProfileManager::set_status(const statusMap &status)
+{
+    get_param(status, names::profiling, enabled_);
+}
+
+
+void ProfileManager::get_status(statusMap &status) const
+{
+    set_param(status, names::profiling, enabled_, "");
+    set_param(status, names::profile, profile_, "");
+}
+
+} // namespace growth
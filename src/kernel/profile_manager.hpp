@@ -0,0 +1,200 @@
+/*
+ * profile_manager.hpp
+ *
+ * This file is part of DeNSE.
+ *
+ * Copyright (C) 2019 SeNEC Initiative
+ *
+ * DeNSE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * DeNSE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DeNSE. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PROFILE_M_H
+#define PROFILE_M_H
+
+// C++ includes
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// kernel includes
+#include "config.hpp"
+#include "manager_interface.hpp"
+
+#ifdef WITH_OMP
+#include <omp.h>
+#endif
+
+
+namespace growth
+{
+
+namespace profiling
+{
+
+//! Timed sections of the simulation (times are inclusive)
+enum Phase
+{
+    GROW,
+    SENSE,
+    MAKE_MOVE,
+    ADD_OBJECT,
+    UPDATE_RTREE,
+    BRANCHING,
+    RECORD,
+    BARRIER,
+    NUM_PHASES
+};
+
+//! Counted operations
+enum Counter
+{
+    STEPS,
+    EVENTS,
+    RTREE_QUERIES,
+    INTERSECTIONS,
+    POLYGONS,
+    MIGRATIONS,
+    NUM_COUNTERS
+};
+
+} // namespace profiling
+
+
+/**
+ * @brief Per-thread timers and counters on the hot paths of the simulation.
+ *
+ * Profiling is enabled through the ``profiling`` kernel parameter; when it is
+ * off, each instrumented section only costs a branch on `enabled_`.
+ * Values are accumulated on each thread during `simulate` and aggregated
+ * at the end, then exposed through the ``profile`` kernel status entry.
+ */
+class ProfileManager : public ManagerInterface
+{
+  public:
+    ProfileManager();
+
+    virtual void initialize();
+    virtual void finalize();
+
+    void set_status(const statusMap &status);
+    void get_status(statusMap &status) const;
+    void num_threads_changed(int num_omp);
+
+    void start_simulation();
+    void finalize_simulation();
+
+    bool enabled() const;
+    void add_time(profiling::Phase phase, double seconds);
+    void count(profiling::Counter counter, stype n = 1);
+
+  private:
+    static int thread_id();
+
+    /*
+     * Values for one thread, padded so that two threads never write on the
+     * same cache line.
+     */
+    struct ThreadProfile
+    {
+        double time[profiling::NUM_PHASES];
+        stype calls[profiling::NUM_PHASES];
+        stype counts[profiling::NUM_COUNTERS];
+        char padding_[64];
+    };
+
+    bool enabled_;
+    std::vector<ThreadProfile> threads_;
+    std::chrono::steady_clock::time_point sim_start_;
+    std::unordered_map<std::string, double> profile_;
+};
+
+
+/**
+ * @brief Scoped timer adding its lifetime to a phase of the profile.
+ */
+class ProfileTimer
+{
+  public:
+    ProfileTimer(ProfileManager &profiler, profiling::Phase phase);
+    ~ProfileTimer();
+
+  private:
+    ProfileManager &profiler_;
+    profiling::Phase phase_;
+    bool active_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+
+// Inline implementations
+
+inline bool ProfileManager::enabled() const { return enabled_; }
+
+
+inline int ProfileManager::thread_id()
+{
+#ifdef WITH_OMP
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+}
+
+
+inline void ProfileManager::add_time(profiling::Phase phase, double seconds)
+{
+    ThreadProfile &tp = threads_[thread_id()];
+
+    tp.time[phase] += seconds;
+    tp.calls[phase]++;
+}
+
+
+inline void ProfileManager::count(profiling::Counter counter, stype n)
+{
+    if (enabled_)
+    {
+        threads_[thread_id()].counts[counter] += n;
+    }
+}
+
+
+inline ProfileTimer::ProfileTimer(ProfileManager &profiler,
+                                  profiling::Phase phase)
+    : profiler_(profiler)
+    , phase_(phase)
+    , active_(profiler.enabled())
+{
+    if (active_)
+    {
+        start_ = std::chrono::steady_clock::now();
+    }
+}
+
+
+inline ProfileTimer::~ProfileTimer()
+{
+    if (active_)
+    {
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start_;
+
+        profiler_.add_time(phase_, elapsed.count());
+    }
+}
+
+} // namespace growth
+
+#endif /* PROFILE_M_H */
@@ -386,8 +386,9 @@ void RecordManager::neurons_deleted(const std::vector<stype> &gids)
             for (stype rec_id : v_crec->second)
             {
                 c_recorders_[rec_id]->neuron_deleted(neuron);
-                neuron_to_c_recorder_.erase(neuron);
             }
+
+            neuron_to_c_recorder_.erase(v_crec);
         }
 
         auto v_drec = neuron_to_d_recorder_.find(neuron);
@@ -397,8 +398,9 @@ void RecordManager::neurons_deleted(const std::vector<stype> &gids)
             for (stype rec_id : v_drec->second)
             {
                 d_recorders_[rec_id]->neuron_deleted(neuron);
-                neuron_to_d_recorder_.erase(neuron);
             }
+
+            neuron_to_d_recorder_.erase(v_drec);
         }
     }
 }
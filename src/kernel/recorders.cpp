@@ -37,6 +37,27 @@
 namespace growth
 {
 
+/**
+ * @brief Name of the neurite associated to an event.
+ *
+ * Returns an empty string if the neuron or the neurite has been deleted.
+ */
+std::string get_event_neurite(const Event &ev)
+{
+    stype gid   = std::get<edata::NEURON>(ev);
+    NeuronPtr n = kernel().neuron_manager.get_neuron(gid);
+
+    if (n == nullptr)
+    {
+        return "";
+    }
+
+    NeuritePtr neurite = n->get_neurite_from_id(std::get<edata::NEURITE>(ev));
+
+    return neurite == nullptr ? "" : neurite->get_name();
+}
+
+
 /**
  * Constructor for BaseRecorder
  */
@@ -714,9 +735,15 @@ void NeuriteDiscreteRecorder::record(const Event &ev)
 {
     Time event_time     = std::get<edata::TIME>(ev);
     stype neuron        = std::get<edata::NEURON>(ev);
-    std::string neurite = std::get<edata::NEURITE>(ev);
+    std::string neurite = get_event_neurite(ev);
     signed char ev_type = std::get<edata::EV_TYPE>(ev);
 
+    // skip events from neurites that were deleted since
+    if (neurite.empty())
+    {
+        return;
+    }
+
     // test which data is recorded
 
     bool branching_event =
@@ -1018,7 +1045,13 @@ void GrowthConeContinuousRecorder::record(const Event &ev)
     // branching event occured on a neuron
     Time event_time     = std::get<edata::TIME>(ev);
     stype neuron        = std::get<edata::NEURON>(ev);
-    std::string neurite = std::get<edata::NEURITE>(ev);
+    std::string neurite = get_event_neurite(ev);
+
+    // skip events from neurites that were deleted since
+    if (neurite.empty())
+    {
+        return;
+    }
 
     std::unordered_map<stype, std::vector<double>> &gc_values =
         recording_[neuron][neurite];
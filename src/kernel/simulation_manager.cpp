@@ -23,9 +23,11 @@
 
 // C includes:
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <limits>
 #include <mutex>
+#include <numeric>
 
 // Includes from kernel
 #include "GrowthCone.hpp"
@@ -38,6 +40,12 @@
 #include "Neuron.hpp"
 
 
+// neurons are moved if the most loaded thread exceeds the mean by this factor
+#define LOAD_IMBALANCE_THRESHOLD 1.1
+// tick of the next event when there is none
+#define NO_EVENT std::numeric_limits<Time::timeTick>::max()
+
+
 namespace growth
 {
 
@@ -49,6 +57,50 @@ auto ev_greater = [](const Event &lhs, const Event &rhs) {
 };
 
 
+/**
+ * @brief Add an event to a heap, the earliest event is at the front.
+ */
+void push_event(std::vector<Event> &heap, const Event &ev)
+{
+    heap.push_back(ev);
+    std::push_heap(heap.begin(), heap.end(), ev_greater);
+}
+
+
+/**
+ * @brief Remove and return the earliest event of a heap.
+ */
+Event pop_event(std::vector<Event> &heap)
+{
+    std::pop_heap(heap.begin(), heap.end(), ev_greater);
+
+    Event ev = heap.back();
+    heap.pop_back();
+
+    return ev;
+}
+
+
+/**
+ * @brief Time of the earliest event of a heap, NO_EVENT if it is empty.
+ */
+Time::timeTick next_event_tick(const std::vector<Event> &heap)
+{
+    return heap.empty() ? NO_EVENT
+                        : std::get<edata::TIME>(heap.front()).get_ticks();
+}
+
+
+/**
+ * @brief OpenMP barrier, the waiting time is recorded when profiling
+ */
+void wait_for_threads()
+{
+    ProfileTimer timer(kernel().profile_manager, profiling::BARRIER);
+#pragma omp barrier
+}
+
+
 SimulationManager::SimulationManager()
     : simulating_(false) //!< true if simulation in progress
     , step_()            //!< Current step of the simulation
@@ -62,6 +114,10 @@ SimulationManager::SimulationManager()
     , previous_resolution_(Time::RESOLUTION)
     , resolution_scale_factor_(1) //! rescale step size respct to old resolution
     , max_resol_(DEFAULT_MAX_RESOL)
+    , load_balancing_(false)
+    , balancing_interval_(DEFAULT_BALANCING_INTERVAL)
+    , growth_cone_tasks_(false)
+    , asynchronous_events_(false)
 {
 }
 
@@ -76,6 +132,11 @@ void SimulationManager::initialize()
     initial_time_  = Time();
     final_time_    = Time();
     max_resol_     = DEFAULT_MAX_RESOL;
+
+    load_balancing_     = false;
+    balancing_interval_ = DEFAULT_BALANCING_INTERVAL;
+    growth_cone_tasks_  = false;
+    asynchronous_events_ = false;
 }
 
 
@@ -83,6 +144,10 @@ void SimulationManager::finalize()
 {
     step_.clear();
     substep_.clear();
+    neuron_work_.clear();
+    branching_ev_.clear();
+    foreign_ev_.clear();
+    next_ev_tick_.clear();
 }
 
 
@@ -151,6 +216,36 @@ void SimulationManager::num_threads_changed(int num_omp)
 
     step_    = std::vector<Time::timeStep>(num_omp, old_step);
     substep_ = std::vector<double>(num_omp, 0.);
+
+    neuron_work_ = std::vector<std::unordered_map<stype, double>>(num_omp);
+
+    // pending events are given to their new thread at the next step
+    for (const auto &heap : branching_ev_)
+    {
+        foreign_ev_.insert(foreign_ev_.end(), heap.begin(), heap.end());
+    }
+
+    branching_ev_ = std::vector<std::vector<Event>>(num_omp);
+    next_ev_tick_ = std::vector<Time::timeTick>(num_omp, NO_EVENT);
+    task_time_    = std::vector<const Time *>(num_omp, nullptr);
+}
+
+
+/**
+ * @brief Set the time returned by `get_time` on the current thread while it
+ * runs a task created by another thread (which can be at another step with
+ * asynchronous events); pass nullptr to use the thread's own time again.
+ *
+ * @return the previous task time, to be restored after the task.
+ */
+const Time *SimulationManager::set_task_time(const Time *t)
+{
+    int omp_id = kernel().parallelism_manager.get_thread_local_id();
+
+    const Time *previous = task_time_[omp_id];
+    task_time_[omp_id]   = t;
+
+    return previous;
 }
 
 
@@ -183,11 +278,20 @@ void SimulationManager::initialize_simulation_(const Time &t)
     step_       = std::vector<Time::timeStep>(num_omp, 0);
     substep_    = std::vector<double>(num_omp, 0.);
 
+    neuron_work_ = std::vector<std::unordered_map<stype, double>>(num_omp);
+
+    // remove the neurons deleted since the last run from the thread lists
+    kernel().neuron_manager.compact_thread_lists();
+
     // make sure branching events are cleared if we start from t = 0
     if (initial_time_ == Time())
     {
-        branching_ev_.clear();
-        branching_ev_tmp_.clear();
+        for (auto &heap : branching_ev_)
+        {
+            heap.clear();
+        }
+
+        foreign_ev_.clear();
     }
 
     // exception_capture_flag "guards" captured_exception. std::called_once()
@@ -213,13 +317,13 @@ void SimulationManager::initialize_simulation_(const Time &t)
 #endif
 
             mtPtr rnd_engine = kernel().rng_manager.get_rng(omp_id);
-            gidNeuronMap local_neurons =
+            const std::vector<NeuronPtr> &local_neurons =
                 kernel().neuron_manager.get_local_neurons(omp_id);
 
             // first, initialize neurons
-            for (auto &neuron : local_neurons)
+            for (const auto &neuron : local_neurons)
             {
-                neuron.second->initialize_next_event(rnd_engine);
+                neuron->initialize_next_event(rnd_engine);
             }
 
             // if time is zero, we need to initialize recorders
@@ -273,12 +377,12 @@ void SimulationManager::finalize_simulation_()
         {
             int omp_id = kernel().parallelism_manager.get_thread_local_id();
 
-            gidNeuronMap local_neurons =
+            const std::vector<NeuronPtr> &local_neurons =
                 kernel().neuron_manager.get_local_neurons(omp_id);
 
-            for (auto &neuron : local_neurons)
+            for (const auto &neuron : local_neurons)
             {
-                neuron.second->finalize();
+                neuron->finalize();
             }
         }
         catch (const std::exception &except)
@@ -310,13 +414,28 @@ void SimulationManager::finalize_simulation_()
 /**
  * @brief add a branching event
  *
- * Add an event into `branching_ev_` and sort the vector.
+ * Events are stored in the heap of the thread which owns the neuron, so the
+ * insertion is lock-free when it is done by that thread (the usual case).
+ * Events created elsewhere (e.g. by a task run on another thread or outside
+ * of the simulation) go through `foreign_ev_` and are moved to the right
+ * heap at the beginning of the next step.
  */
 void SimulationManager::new_branching_event(const Event &ev)
 {
-#pragma omp critical
+    int omp_id = kernel().parallelism_manager.get_thread_local_id();
+    stype gid  = std::get<edata::NEURON>(ev);
+
+    if (static_cast<stype>(omp_id) < branching_ev_.size() and
+        kernel().neuron_manager.get_local_neuron(gid, omp_id) != nullptr)
     {
-        branching_ev_tmp_.push_back(ev);
+        push_event(branching_ev_[omp_id], ev);
+    }
+    else
+    {
+#pragma omp critical
+        {
+            foreign_ev_.push_back(ev);
+        }
     }
 }
 
@@ -331,6 +450,10 @@ void SimulationManager::new_branching_event(const Event &ev)
  */
 void SimulationManager::simulate(const Time &t)
 {
+    ProfileManager &profiler = kernel().profile_manager;
+
+    profiler.start_simulation();
+
     initialize_simulation_(t);
 
     // exception_capture_flag "guards" captured_exception. std::called_once()
@@ -348,16 +471,18 @@ void SimulationManager::simulate(const Time &t)
 
 #pragma omp parallel
     {
-        int omp_id = kernel().parallelism_manager.get_thread_local_id();
+        int omp_id  = kernel().parallelism_manager.get_thread_local_id();
+        int num_omp = kernel().parallelism_manager.get_num_local_threads();
         stype current_step;
-        Time time_next_ev;
+        Time::timeTick tick_next_ev;
 
         double previous_substep = 0.;
         bool new_step           = false;
         bool branching          = false;
 
         mtPtr rnd_engine = kernel().rng_manager.get_rng(omp_id);
-        gidNeuronMap local_neurons =
+        // thread list (updated in place by load balancing)
+        const std::vector<NeuronPtr> &local_neurons =
             kernel().neuron_manager.get_local_neurons(omp_id);
 
         // then run the simulation
@@ -369,162 +494,256 @@ void SimulationManager::simulate(const Time &t)
             current_step     = step_[omp_id];
             previous_substep = substep_[omp_id];
 
-#pragma omp barrier
+            wait_for_threads();
 
-#pragma omp single
+            std::vector<Event> &local_events = branching_ev_[omp_id];
+
+            // move the events created outside of their thread
+            if (not foreign_ev_.empty())
             {
-                if (!branching_ev_tmp_.empty())
+                for (const auto &ev : foreign_ev_)
                 {
-                    branching_ev_.insert(branching_ev_.end(),
-                                         branching_ev_tmp_.begin(),
-                                         branching_ev_tmp_.end());
+                    stype gid = std::get<edata::NEURON>(ev);
 
-                    branching_ev_tmp_.clear();
+                    if (kernel().neuron_manager.get_local_neuron(
+                            gid, omp_id) != nullptr)
+                    {
+                        push_event(local_events, ev);
+                    }
+                }
 
-                    std::sort(branching_ev_.begin(), branching_ev_.end(),
-                              ev_greater);
+                wait_for_threads();
+#pragma omp single
+                {
+                    foreign_ev_.clear();
                 }
             }
 
-#pragma omp barrier
+            // publish the time of the next local event
+            if (not asynchronous_events_)
+            {
+                next_ev_tick_[omp_id] = next_event_tick(local_events);
+            }
+
+            // all threads must be done with `foreign_ev_` before the growth
+            // (or tasks run for other threads) can add new events to it
+            wait_for_threads();
 
             // -------------- //
             // EVENT HANDLING //
             // -------------- //
 
-            // check when the next event will occur and set step/substep
-            if (branching_ev_.empty())
+            // in asynchronous mode, each thread goes through its own events
+            // until the end of the step without waiting for the others; the
+            // other threads' neurites are seen as they were at the previous
+            // step, which is safe since the resolution is bounded so that a
+            // growth cone cannot move more than its sensing distance in one
+            // step (see `max_allowed_resolution`)
+            bool local_branching = false;
+
+            do
             {
-                new_step  = true;
-                branching = false;
+                if (local_branching)
+                {
+                    previous_substep = substep_[omp_id];
+                }
 
-                if (current_step + 1 == final_step_)
+                if (asynchronous_events_)
                 {
-                    substep_[omp_id] = final_substep_;
+                    // next local event
+                    tick_next_ev = next_event_tick(local_events);
                 }
                 else
                 {
-                    substep_[omp_id] = Time::RESOLUTION;
+                    // global time of the next event (min over the threads)
+                    tick_next_ev = *std::min_element(next_ev_tick_.begin(),
+                                                     next_ev_tick_.end());
                 }
-            }
-            else
-            {
-                Time next_time = initial_time_;
-                next_time.update(current_step + 1, 0);
-
-                time_next_ev = std::get<edata::TIME>(branching_ev_.back());
-                branching    = false;
-                new_step     = false;
 
-                if (time_next_ev < next_time)
+                // check when the next event will occur and set step/substep
+                if (tick_next_ev == NO_EVENT)
                 {
-                    substep_[omp_id] =
-                        Time::RESOLUTION - (next_time.get_total_minutes() -
-                                            time_next_ev.get_total_minutes());
+                    new_step  = true;
+                    branching = false;
 
-                    if (current_step == final_step_ and
-                        substep_[omp_id] > final_substep_)
+                    if (current_step + 1 == final_step_)
                     {
                         substep_[omp_id] = final_substep_;
                     }
                     else
                     {
-                        new_step  = (substep_[omp_id] == Time::RESOLUTION);
-                        branching = true;
+                        substep_[omp_id] = Time::RESOLUTION;
                     }
                 }
-                else if (current_step == final_step_)
-                {
-                    substep_[omp_id] = final_substep_;
-                }
                 else
                 {
-                    substep_[omp_id] = Time::RESOLUTION;
-                    new_step         = true;
-                }
-            }
-
-            assert(substep_[omp_id] >= 0.);
-
-            // update neurons
-            for (auto &neuron : local_neurons)
-            {
-                try
-                {
-                    //~ printf("growing neuron %lu\n", neuron.first);
-                    neuron.second->grow(rnd_engine, current_step,
-                                        substep_[omp_id] - previous_substep);
-                    //~ printf("neuron %lu grown\n", neuron.first);
-                }
-                catch (...)
-                {
-                    std::call_once(
-                        exception_capture_flag, [&captured_exception]() {
-                            captured_exception = std::current_exception();
-                        });
-                    exceptions.push_back(captured_exception);
-                }
-            }
+                    Time next_time = initial_time_;
+                    next_time.update(current_step + 1, 0);
 
-            if (branching)
-            {
-                // someone has to branch
-                Event &ev           = branching_ev_.back();
-                stype gid_branching = std::get<edata::NEURON>(ev);
-                auto it             = local_neurons.find(gid_branching);
+                    branching = false;
+                    new_step  = false;
 
-                if (it != local_neurons.end())
-                {
-                    bool branched = false;
-                    try
+                    if (tick_next_ev < next_time.get_ticks())
+                    {
+                        // exact integer difference between the two times
+                        substep_[omp_id] =
+                            Time::RESOLUTION -
+                            Time::ticks_to_minutes(next_time.get_ticks() -
+                                                   tick_next_ev);
+
+                        if (current_step == final_step_ and
+                            substep_[omp_id] > final_substep_)
+                        {
+                            substep_[omp_id] = final_substep_;
+                        }
+                        else
+                        {
+                            new_step  = (substep_[omp_id] == Time::RESOLUTION);
+                            branching = true;
+                        }
+                    }
+                    else if (current_step == final_step_)
                     {
-                        branched = local_neurons[gid_branching]->branch(
-                            rnd_engine, ev);
+                        substep_[omp_id] = final_substep_;
                     }
-                    catch (...)
+                    else
                     {
-                        std::call_once(
-                            exception_capture_flag, [&captured_exception]() {
-                                captured_exception = std::current_exception();
-                            });
-                        exceptions.push_back(captured_exception);
+                        substep_[omp_id] = Time::RESOLUTION;
+                        new_step         = true;
                     }
+                }
 
-                    // tell recorder manager
-                    if (branched)
+                assert(substep_[omp_id] >= 0.);
+
+                // update neurons
+                {
+                    ProfileTimer timer(profiler, profiling::GROW);
+
+                    for (const auto &neuron : local_neurons)
                     {
-                        kernel().record_manager.new_branching_event(ev);
+                        try
+                        {
+                            std::chrono::steady_clock::time_point start;
+
+                            if (load_balancing_)
+                            {
+                                start = std::chrono::steady_clock::now();
+                            }
+
+                            neuron->grow(rnd_engine, current_step,
+                                         substep_[omp_id] - previous_substep);
+
+                            // measure the work associated to each neuron
+                            if (load_balancing_)
+                            {
+                                std::chrono::duration<double> work =
+                                    std::chrono::steady_clock::now() - start;
+
+                                neuron_work_[omp_id][neuron->get_gid()] +=
+                                    work.count();
+                            }
+                        }
+                        catch (...)
+                        {
+                            std::call_once(exception_capture_flag,
+                                           [&captured_exception]() {
+                                               captured_exception =
+                                                   std::current_exception();
+                                           });
+                            exceptions.push_back(captured_exception);
+                        }
                     }
                 }
 
-                // wait for everyone to check, then remove event
-#pragma omp barrier
-#pragma omp single
+                // process the local events occurring now, other threads do not
+                // need to wait for them
+                while (branching and
+                       next_event_tick(local_events) == tick_next_ev)
                 {
-                    branching_ev_.pop_back();
+                    Event ev            = pop_event(local_events);
+                    stype gid_branching = std::get<edata::NEURON>(ev);
+                    Neuron *neuron =
+                        kernel().neuron_manager.get_local_neuron(gid_branching,
+                                                                 omp_id);
+
+                    profiler.count(profiling::EVENTS);
+
+                    // the neuron may have been deleted
+                    if (neuron != nullptr)
+                    {
+                        ProfileTimer timer(profiler, profiling::BRANCHING);
+
+                        bool branched = false;
+                        try
+                        {
+                            branched = neuron->branch(rnd_engine, ev);
+                        }
+                        catch (...)
+                        {
+                            std::call_once(exception_capture_flag,
+                                           [&captured_exception]() {
+                                               captured_exception =
+                                                   std::current_exception();
+                                           });
+                            exceptions.push_back(captured_exception);
+                        }
+
+                        // tell recorder manager (recorders can be shared by
+                        // neurons of several threads)
+                        if (branched)
+                        {
+#pragma omp critical
+                            {
+                                kernel().record_manager.new_branching_event(
+                                    ev);
+                            }
+                        }
+                    }
                 }
-            }
 
-#pragma omp barrier
+                local_branching = asynchronous_events_ and branching;
+            } while (local_branching and not terminate_);
+
+            wait_for_threads();
             // update the R-tree
             kernel().space_manager.update_rtree();
             // wait for the update
-#pragma omp barrier
+            wait_for_threads();
 
             if (new_step)
             {
                 // full step is completed, record
                 // reset substep_, increment step_
-                kernel().record_manager.record(omp_id);
+                {
+                    ProfileTimer timer(profiler, profiling::RECORD);
+                    kernel().record_manager.record(omp_id);
+                }
+
                 substep_[omp_id] = 0.;
                 step_[omp_id]++;
+
+                if (omp_id == 0)
+                {
+                    profiler.count(profiling::STEPS);
+                }
             }
 
-#pragma omp barrier
+            wait_for_threads();
             if (not exceptions.empty())
             {
                 terminate_ = true;
             }
+
+            // move neurons between threads if the load is unbalanced; all
+            // threads share the same step so they all enter the single region
+            if (load_balancing_ and new_step and num_omp > 1 and
+                step_[omp_id] % balancing_interval_ == 0)
+            {
+#pragma omp single
+                {
+                    balance_load_();
+                }
+            }
         }
     }
 
@@ -549,6 +768,136 @@ void SimulationManager::simulate(const Time &t)
     }
 
     finalize_simulation_();
+
+    profiler.finalize_simulation();
+}
+
+
+/**
+ * @brief Move neurons from the most loaded threads to the least loaded ones.
+ *
+ * The load of each thread is the time spent growing its neurons since the
+ * previous call. Neurons are moved one at a time, from the most to the least
+ * loaded thread, choosing the largest neuron which does not exceed half of
+ * the load difference, until the most loaded thread is within
+ * LOAD_IMBALANCE_THRESHOLD of the mean load.
+ */
+void SimulationManager::balance_load_()
+{
+    stype num_omp = neuron_work_.size();
+    std::vector<double> load(num_omp, 0.);
+
+    for (stype i = 0; i < num_omp; i++)
+    {
+        for (const auto &nw : neuron_work_[i])
+        {
+            load[i] += nw.second;
+        }
+    }
+
+    double mean = std::accumulate(load.begin(), load.end(), 0.) / num_omp;
+
+    stype num_moved = 0;
+    stype max_moves = kernel().neuron_manager.num_neurons();
+
+    while (mean > 0 and num_moved < max_moves)
+    {
+        stype imax = std::max_element(load.begin(), load.end()) - load.begin();
+        stype imin = std::min_element(load.begin(), load.end()) - load.begin();
+
+        if (load[imax] < LOAD_IMBALANCE_THRESHOLD * mean)
+        {
+            break;
+        }
+
+        // largest neuron that does not invert the imbalance (smallest gid
+        // on ties so that the choice does not depend on the map order)
+        double half_gap  = 0.5 * (load[imax] - load[imin]);
+        double best_work = 0.;
+        stype best_gid   = 0;
+
+        for (const auto &nw : neuron_work_[imax])
+        {
+            if (nw.second <= half_gap and
+                (nw.second > best_work or
+                 (nw.second == best_work and best_work > 0 and
+                  nw.first < best_gid)))
+            {
+                best_work = nw.second;
+                best_gid  = nw.first;
+            }
+        }
+
+        if (best_work == 0.)
+        {
+            break;
+        }
+
+        kernel().neuron_manager.move_neuron(best_gid, imin);
+
+        neuron_work_[imax].erase(best_gid);
+        neuron_work_[imin][best_gid] = best_work;
+
+        load[imax] -= best_work;
+        load[imin] += best_work;
+
+        num_moved++;
+    }
+
+    kernel().profile_manager.count(profiling::MIGRATIONS, num_moved);
+
+    // pending events of the moved neurons are given to their new thread
+    if (num_moved > 0)
+    {
+        kernel().neuron_manager.compact_thread_lists();
+
+        for (stype i = 0; i < num_omp; i++)
+        {
+            std::vector<Event> &heap = branching_ev_[i];
+
+            auto it = std::partition(
+                heap.begin(), heap.end(), [i](const Event &ev) {
+                    return kernel().neuron_manager.get_local_neuron(
+                               std::get<edata::NEURON>(ev), i) != nullptr;
+                });
+
+            foreign_ev_.insert(foreign_ev_.end(), it, heap.end());
+            heap.erase(it, heap.end());
+
+            std::make_heap(heap.begin(), heap.end(), ev_greater);
+        }
+    }
+
+    for (auto &work : neuron_work_)
+    {
+        work.clear();
+    }
+}
+
+
+/**
+ * @brief Drop the pending events of deleted neurons.
+ */
+void SimulationManager::neurons_deleted(const std::unordered_set<stype> &gids)
+{
+    auto deleted = [&gids](const Event &ev) {
+        return gids.find(std::get<edata::NEURON>(ev)) != gids.end();
+    };
+
+    for (auto &heap : branching_ev_)
+    {
+        auto it = std::remove_if(heap.begin(), heap.end(), deleted);
+
+        if (it != heap.end())
+        {
+            heap.erase(it, heap.end());
+            std::make_heap(heap.begin(), heap.end(), ev_greater);
+        }
+    }
+
+    foreign_ev_.erase(
+        std::remove_if(foreign_ev_.begin(), foreign_ev_.end(), deleted),
+        foreign_ev_.end());
 }
 
 
@@ -558,6 +907,21 @@ void SimulationManager::simulate(const Time &t)
 
 void SimulationManager::set_status(const statusMap &status)
 {
+    get_param(status, names::asynchronous_events, asynchronous_events_);
+    get_param(status, names::growth_cone_tasks, growth_cone_tasks_);
+    get_param(status, names::load_balancing, load_balancing_);
+
+    stype interval = balancing_interval_;
+    get_param(status, names::load_balancing_interval, interval);
+
+    if (interval == 0)
+    {
+        throw std::invalid_argument("`" + names::load_balancing_interval +
+                                    "` must be strictly positive.");
+    }
+
+    balancing_interval_ = interval;
+
     if (status.find("resolution") != status.end())
     {
         get_param(status, names::max_allowed_resolution, max_resol_);
@@ -587,6 +951,11 @@ void SimulationManager::get_status(statusMap &status) const
 {
     set_param(status, names::resolution, Time::RESOLUTION, "minute");
     set_param(status, names::max_allowed_resolution, max_resol_, "minute");
+    set_param(status, names::asynchronous_events, asynchronous_events_, "");
+    set_param(status, names::growth_cone_tasks, growth_cone_tasks_, "");
+    set_param(status, names::load_balancing, load_balancing_, "");
+    set_param(status, names::load_balancing_interval, balancing_interval_,
+              "");
 
     // initial time is always up to date
     set_param(status, "second", initial_time_.get_sec(), "second");
@@ -619,7 +988,14 @@ const Time &SimulationManager::get_initial_time() const
 Time SimulationManager::get_time() const
 {
     int omp_id = kernel().parallelism_manager.get_thread_local_id();
-    Time t0    = Time(initial_time_);
+
+    if (static_cast<stype>(omp_id) < task_time_.size() and
+        task_time_[omp_id] != nullptr)
+    {
+        return *task_time_[omp_id];
+    }
+
+    Time t0 = Time(initial_time_);
 
     t0.update(step_[omp_id], substep_[omp_id]);
 
@@ -23,6 +23,8 @@
 #define SIMULATION_M_H
 
 #include <random>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "config.hpp"
@@ -54,9 +56,13 @@ class SimulationManager : public ManagerInterface
     virtual void get_status(statusMap &) const;
     void num_threads_changed(int num_omp);
     void new_branching_event(const Event &ev);
+    void neurons_deleted(const std::unordered_set<stype> &gids);
     bool simulating() const;
+    bool growth_cone_tasks() const;
+    bool asynchronous_events() const;
 
     Time get_time() const;
+    const Time *set_task_time(const Time *t);
     const Time &get_initial_time() const;
     double get_resolution() const;
     double get_current_minutes() const;
@@ -72,13 +78,21 @@ class SimulationManager : public ManagerInterface
   private:
     void initialize_simulation_(const Time &t);
     void finalize_simulation_();
+    void balance_load_();
 
     bool simulating_;
     double previous_resolution_;
     std::vector<Time::timeStep> step_;
     std::vector<double> substep_;
-    std::vector<Event> branching_ev_;
-    std::vector<Event> branching_ev_tmp_;
+    // per-thread min-heaps with the branching events of the local neurons
+    std::vector<std::vector<Event>> branching_ev_;
+    // events created outside of the thread of their neuron, moved to the
+    // right heap at the beginning of the next step
+    std::vector<Event> foreign_ev_;
+    // time of the next local event on each thread (for the min reduction)
+    std::vector<Time::timeTick> next_ev_tick_;
+    // time of the task run by each thread (nullptr outside of tasks)
+    std::vector<const Time *> task_time_;
     double final_substep_;
     Time::timeStep final_step_;
     Time initial_time_;
@@ -87,6 +101,14 @@ class SimulationManager : public ManagerInterface
     bool terminate_;
     double resolution_scale_factor_;
     double max_resol_; // maximum allowed resolution
+    // load balancing
+    bool load_balancing_;
+    stype balancing_interval_; // number of steps between two balancings
+    std::vector<std::unordered_map<stype, double>> neuron_work_;
+    // grow the growth cones of large neurites as OpenMP tasks
+    bool growth_cone_tasks_;
+    // threads only synchronize at full steps and not at each event
+    bool asynchronous_events_;
 };
 
 
@@ -95,6 +117,18 @@ class SimulationManager : public ManagerInterface
  */
 inline void SimulationManager::terminate() { terminate_ = true; }
 
+
+inline bool SimulationManager::growth_cone_tasks() const
+{
+    return growth_cone_tasks_;
+}
+
+
+inline bool SimulationManager::asynchronous_events() const
+{
+    return asynchronous_events_;
+}
+
 } // namespace growth
 
 #endif /* SIMULATION_M_H */
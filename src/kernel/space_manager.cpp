@@ -22,6 +22,7 @@
 #include "space_manager.hpp"
 
 // C++ includes
+#include <algorithm>
 #include <cmath>
 #include <deque>
 #include <iostream>
@@ -42,9 +43,18 @@
 
 // spatial include
 #include "Area.hpp"
+#include "DistanceField.hpp"
 #include "Environment.hpp"
 
 
+// number of potential synaptic sites processed as one block of work
+#define SYNAPSE_CHUNK_SIZE 64
+// the R-tree is rebuilt instead of removing the segments one by one if a
+// step removes at least this number and this fraction of its segments
+#define MIN_REBUILD_REMOVALS 256
+#define REBUILD_FRACTION 0.1
+
+
 namespace growth
 {
 
@@ -78,17 +88,28 @@ void log_and_exit(const char *fmt, ...)
 
 
 SpaceManager::SpaceManager()
-    : initialized_(false)
-    , interactions_(true)
-    , environment_initialized_(false)
-    , environment_manager_(nullptr)
-    , context_handler_(nullptr)
-    , points_per_circle_(DEFAULT_POINTS_PER_CIRCLE)
+    : points_per_circle_(DEFAULT_POINTS_PER_CIRCLE)
     , join_strategy_(DEFAULT_POINTS_PER_CIRCLE)
     , circle_strategy_(DEFAULT_POINTS_PER_CIRCLE)
+    , initialized_(false)
+    , environment_initialized_(false)
+    , interactions_(true)
+    , compact_geometry_(false)
+    , context_handler_(nullptr)
+    , environment_manager_(nullptr)
+    , distance_field_(nullptr)
+    , distance_field_resolution_(DISTANCE_FIELD_RESOLUTION)
     , max_syn_distance_(MAX_MAX_SYN_DIST)
-    , uniform_(0., 1.)
+    , track_contacts_(false)
+    , contact_log_read_(0)
 {
+    // same vertices as the circle_strategy_ buffers
+    double diff = 2 * M_PI / points_per_circle_;
+
+    for (int i = 0; i < points_per_circle_; i++)
+    {
+        circle_vertices_.push_back(BPoint(cos(-i * diff), sin(-i * diff)));
+    }
 }
 
 
@@ -101,8 +122,10 @@ void SpaceManager::initialize()
 
     int num_omp = kernel().parallelism_manager.get_num_local_threads();
 
-    geom_add_buffer_ = std::vector<space_tree_map>(num_omp);
+    geom_add_buffer_ = std::vector<geometry_map>(num_omp);
     box_buffer_      = std::vector<std::vector<box_tree_tuple>>(num_omp);
+    new_contacts_    = std::vector<ContactBuffer>(num_omp);
+    new_segments_    = std::vector<std::vector<RtreeValue>>(num_omp);
     initialized_     = true;
 }
 
@@ -119,10 +142,13 @@ void SpaceManager::finalize()
     // clear environment
     environment_initialized_ = false;
     environment_manager_ = nullptr;
+    distance_field_      = nullptr;
     areas_.clear();
 
-    // reset interactions
-    interactions_ = true;
+    // reset interactions, resolution and point storage
+    interactions_              = true;
+    distance_field_resolution_ = DISTANCE_FIELD_RESOLUTION;
+    compact_geometry_          = false;
 
     // remove synapses
     known_synaptic_sites_.clear();
@@ -131,6 +157,16 @@ void SpaceManager::finalize()
     old_potential_synapse_near_.clear();
     new_potential_synapse_near_.clear();
 
+    // reset contact tracking
+    track_contacts_ = false;
+    new_contacts_.clear();
+    new_segments_.clear();
+    contact_log_      = ContactBuffer();
+    contact_log_time_.clear();
+    contact_log_read_ = 0;
+    contact_keys_.clear();
+    contact_objects_.clear();
+
     GEOS_finish_r(context_handler_);
 }
 
@@ -224,6 +260,91 @@ void correct_polygon(const BPoint &vec_step, const BPoint &vec_ortho,
 }
 
 
+/**
+ * @brief Constant-time validity test for the segment polygons
+ *
+ * Segment polygons are triangles or quadrilaterals (a closed ring of 4 or 5
+ * points), so validity reduces to the orientation (sign of the area, boost
+ * polygons are clockwise) and to the intersections between non-adjacent
+ * edges.
+ * Degenerate shapes (non-finite coordinates, null area, collinear edges or
+ * other rings) are passed to the general `bg::is_valid`, and so is every
+ * polygon in debug mode to check that both tests agree.
+ */
+bool is_valid_segment(const BPolygon &poly, bg::validity_failure_type &failure)
+{
+    const BRing &ring = poly.outer();
+    stype n           = ring.size() - 1;
+
+    bool general = (n != 3 and n != 4) or not poly.inners().empty() or
+                   ring.front().x() != ring.back().x() or
+                   ring.front().y() != ring.back().y();
+
+    auto cross = [&ring, n](stype i, stype j, stype k) {
+        const BPoint &a = ring[i % n];
+        const BPoint &b = ring[j % n];
+        const BPoint &c = ring[k % n];
+        return (b.x() - a.x()) * (c.y() - a.y()) -
+               (b.y() - a.y()) * (c.x() - a.x());
+    };
+
+    double area = 0.;
+
+    for (stype i = 0; i < n and not general; i++)
+    {
+        // NaN or infinite coordinates (reported by boost)
+        if (not std::isfinite(ring[i].x()) or not std::isfinite(ring[i].y()))
+        {
+            general = true;
+            break;
+        }
+
+        area += ring[i].x() * ring[i + 1].y() - ring[i + 1].x() * ring[i].y();
+
+        // collinear consecutive edges (spikes or duplicate points)
+        general = cross(i, i + 1, i + 2) == 0.;
+    }
+
+    if (general or area == 0.)
+    {
+        return bg::is_valid(poly, failure);
+    }
+
+    failure = bg::no_failure;
+
+    if (area > 0.)
+    {
+        // counter-clockwise
+        failure = bg::failure_wrong_orientation;
+    }
+    else if (n == 4)
+    {
+        // non-adjacent edges are (0, 1) with (2, 3) and (1, 2) with (3, 0)
+        for (stype i = 0; i < 2; i++)
+        {
+            double d1 = cross(i, i + 1, i + 2);
+            double d2 = cross(i, i + 1, i + 3);
+            double d3 = cross(i + 2, i + 3, i);
+            double d4 = cross(i + 2, i + 3, i + 1);
+
+            if (d1 * d2 <= 0 and d3 * d4 <= 0)
+            {
+                failure = bg::failure_self_intersections;
+                break;
+            }
+        }
+    }
+
+#ifndef NDEBUG
+    bg::validity_failure_type boost_failure;
+    bg::is_valid(poly, boost_failure);
+    assert(boost_failure == failure);
+#endif
+
+    return failure == bg::no_failure;
+}
+
+
 BPolygon SpaceManager::make_disk(BPoint position, double radius) const
 {
     BMultiPolygon geom;
@@ -244,11 +365,17 @@ void SpaceManager::add_object(const BPoint &start, const BPoint &stop,
                               double diam, double length, double taper,
                               const ObjectInfo &info, BranchPtr b, int omp_id)
 {
+    ProfileTimer timer(kernel().profile_manager, profiling::ADD_OBJECT);
+
     // objects should be added only once the manager has been initialized
     if (initialized_)
     {
         BMultiPolygon geom;
-        BPolygonPtr poly;
+
+        // the polygon is built in place, then kept as is or compacted
+        std::shared_ptr<FullGeometry> full = std::make_shared<FullGeometry>();
+        BPolygonPtr poly(full, &full->polygon);
+        GeometryPtr stored = full;
 
         bool is_soma = std::get<1>(info).empty() ? true : false;
 
@@ -267,7 +394,7 @@ void SpaceManager::add_object(const BPoint &start, const BPoint &stop,
             bg::buffer(start, geom, distance_strategy, side_strategy_,
                        join_strategy_, end_strategy_, circle_strategy_);
 
-            poly = std::make_shared<BPolygon>(geom[0]);
+            full->polygon = geom[0];
         }
         else
         {
@@ -290,8 +417,7 @@ void SpaceManager::add_object(const BPoint &start, const BPoint &stop,
 
             BPoint old_lp1, old_lp2;
 
-            // create an empty polygon and add the points
-            poly         = std::make_shared<BPolygon>();
+            // add the points to the empty polygon
             BRing &outer = poly->outer();
 
             if (last_segment == nullptr)
@@ -318,7 +444,7 @@ void SpaceManager::add_object(const BPoint &start, const BPoint &stop,
             unsigned int count = 0;
             bool checked_order = false;
 
-            while (not bg::is_valid(*(poly.get()), failure))
+            while (not is_valid_segment(*(poly.get()), failure))
             {
                 if (failure == bg::failure_self_intersections)
                 {
@@ -414,7 +540,7 @@ void SpaceManager::add_object(const BPoint &start, const BPoint &stop,
                     bg::correct(*(poly.get()));
                 }
 
-                success = bg::is_valid(*(poly.get()), message);
+                success = is_valid_segment(*(poly.get()), failure);
 
                 if (success or count > 5)
                 {
@@ -424,8 +550,11 @@ void SpaceManager::add_object(const BPoint &start, const BPoint &stop,
                 count++;
             }
 
-            if (not bg::is_valid(*(poly.get()), message))
+            if (not is_valid_segment(*(poly.get()), failure))
             {
+                // get the full description from boost
+                bg::is_valid(*(poly.get()), message);
+
                 std::cout << "last points: " << bg::wkt(old_lp1) << " "
                           << bg::wkt(old_lp2) << std::endl
                           << bg::wkt(*(poly.get())) << std::endl;
@@ -440,17 +569,29 @@ void SpaceManager::add_object(const BPoint &start, const BPoint &stop,
 
             if (success)
             {
-                b->add_point(stop, length, poly, lp_1, lp_2);
+                if (compact_geometry_ and CompactGeometry::fits(*poly))
+                {
+                    stored = std::make_shared<CompactGeometry>(*poly);
+                }
+
+                b->add_point(stop, length, stored, lp_1, lp_2);
             }
         }
 
         if (success)
         {
             // add polygon
-            geom_add_buffer_[omp_id][info] = poly;
+            geom_add_buffer_[omp_id][info] = stored;
             // add box, so `true` in box buffer
             BBox box = bg::return_envelope<BBox>(*(poly.get()));
             box_buffer_[omp_id].push_back(std::make_tuple(info, box, true));
+
+            kernel().profile_manager.count(profiling::POLYGONS);
+
+            if (track_contacts_)
+            {
+                record_contacts(info, *(poly.get()), box, omp_id);
+            }
         }
 #ifndef NDEBUG
         else
@@ -470,57 +611,203 @@ void SpaceManager::remove_object(const BBox &box, const ObjectInfo &info,
 }
 
 
-void SpaceManager::update_objects_branching(
-  TNodePtr old_node, NodePtr new_node, stype branching_point,
-  stype neuron, const std::string &neurite, int omp_id)
+/**
+ * @brief Remove all the entries matching `pred` from the R-tree in one pass.
+ *
+ * The tree is rebuilt from the remaining segments with the packing
+ * algorithm, which is much cheaper than removing the segments one by one
+ * when whole neurons or neurites are deleted.
+ * Must only be called between two steps, when the buffers are empty.
+ */
+template <class Predicate>
+void SpaceManager::remove_objects_if(Predicate pred)
+{
+    std::vector<RtreeValue> values;
+    values.reserve(rtree_.size());
+
+    auto kept = [&pred](const RtreeValue &v) { return not pred(v.second); };
+
+    rtree_.query(bgi::satisfies(kept), std::back_inserter(values));
+
+    if (values.size() < rtree_.size())
+    {
+        rtree_ = bgi::rtree<RtreeValue, bgi::quadratic<16>>(values);
+
+        for (auto it = map_geom_.begin(); it != map_geom_.end();)
+        {
+            if (pred(it->first))
+            {
+                it = map_geom_.erase(it);
+            }
+            else
+            {
+                it++;
+            }
+        }
+
+        purge_contact_log(pred);
+    }
+}
+
+
+/**
+ * @brief Remove the logged contacts involving an object matching `pred`.
+ */
+template <class Predicate>
+void SpaceManager::purge_contact_log(Predicate pred)
+{
+    if (contact_objects_.empty())
+    {
+        return;
+    }
+
+    ContactBuffer kept;
+    std::vector<double> kept_time;
+    stype read = 0;
+
+    for (stype i = 0; i < contact_log_.size(); i++)
+    {
+        ObjectInfo pre(contact_log_.presyn(i)), post(contact_log_.postsyn(i));
+
+        if (not pred(pre) and not pred(post))
+        {
+            kept.add_contact(pre, post, contact_log_.contact_area[i],
+                             BPoint(contact_log_.contact_x[i],
+                                    contact_log_.contact_y[i]));
+            kept_time.push_back(contact_log_time_[i]);
+
+            read += (i < contact_log_read_);
+        }
+        else
+        {
+            contact_keys_.erase(std::make_pair(pre, post));
+
+            for (const ObjectInfo &info : {pre, post})
+            {
+                auto it = contact_objects_.find(info);
+
+                if (--(it->second) == 0)
+                {
+                    contact_objects_.erase(it);
+                }
+            }
+        }
+    }
+
+    contact_log_ = std::move(kept);
+    contact_log_time_.swap(kept_time);
+    contact_log_read_ = read;
+}
+
+
+/**
+ * @brief Remove all the segments (and somas) of a set of neurons.
+ */
+void SpaceManager::remove_neurons(const std::unordered_set<stype> &gids)
+{
+    remove_objects_if([&gids](const ObjectInfo &info) {
+        return gids.find(std::get<ndata::NEURON>(info)) != gids.end();
+    });
+}
+
+
+/**
+ * @brief Remove all the segments of a set of neurites, given as
+ * {neuron: neurite names}.
+ */
+void SpaceManager::remove_neurites(
+    const std::unordered_map<stype, std::unordered_set<std::string>>
+        &neurites)
 {
-    BPolygonPtr poly;
-    BBox box;
-    ObjectInfo info;
+    remove_objects_if([&neurites](const ObjectInfo &info) {
+        auto it = neurites.find(std::get<ndata::NEURON>(info));
+
+        return it != neurites.end() and
+               it->second.find(std::get<ndata::NEURITE>(info)) !=
+                   it->second.end();
+    });
+}
 
-    stype old_id(old_node->get_node_id()), new_id(new_node->get_node_id());
-    const BranchPtr old_branch(old_node->get_branch());
-    const BranchPtr new_branch(new_node->get_branch());
 
-    // stype num_old_segments = max(old_branch->size() - 2, 0);
-    // stype num_new_segments = max(new_branch->size() - 2, 0);
+/**
+ * @brief Replace the keys of the segments (see
+ * :cpp:func:`Neurite::segment_key`) by their current node id and index on
+ * the node's branch, from index `start` of the tables.
+ */
+void SpaceManager::segment_positions(const std::vector<stype> &neurons,
+                                     const std::vector<std::string> &neurites,
+                                     std::vector<stype> &nodes,
+                                     std::vector<stype> &segments,
+                                     stype start) const
+{
+    std::shared_ptr<const Neurite> neurite;
 
-    // change node ids below branching point
-    for (stype i = 0; i < branching_point; i++)
+    for (stype i = start; i < nodes.size(); i++)
     {
-        poly = new_branch->get_segment_at(i);
-        box  = bg::return_envelope<BBox>(*(poly.get()));
-        info = std::make_tuple(neuron, neurite, old_id, i);
+        // somas are not split
+        if (neurites[i].empty())
+        {
+            continue;
+        }
+
+        // consecutive entries often come from the same neurite
+        if (neurite == nullptr or neurite->get_name() != neurites[i] or
+            neurite->get_parent_neuron().lock()->get_gid() != neurons[i])
+        {
+            NeuronPtr neuron = kernel().neuron_manager.get_neuron(neurons[i]);
 
-        // remove old version
-        remove_object(box, info, omp_id);
+            neurite = nullptr;
+
+            if (neuron != nullptr and neuron->is_neurite(neurites[i]))
+            {
+                neurite = neuron->get_neurite(neurites[i]).lock();
+            }
+        }
 
-        // readd, associated to new node
-        info = std::make_tuple(neuron, neurite, new_id, i);
-        // add polygon
-        geom_add_buffer_[omp_id][info] = poly;
-        // add box, so `true` in box buffer
-        box_buffer_[omp_id].push_back(std::make_tuple(info, box, true));
+        // the ids of deleted neurites are kept as they are
+        if (neurite != nullptr)
+        {
+            neurite->segment_position(nodes[i], segments[i]);
+        }
     }
+}
+
 
-    // change segment ids above branching point
-    stype imax = old_branch->size() > 0 ? old_branch->size() - 1 : 0;
+/**
+ * @brief Convert segment positions (node id and index on the node's branch)
+ * back into the keys of the spatial index.
+ */
+void SpaceManager::segment_keys(const std::vector<stype> &neurons,
+                                const std::vector<std::string> &neurites,
+                                std::vector<stype> &nodes,
+                                std::vector<stype> &segments) const
+{
+    std::shared_ptr<const Neurite> neurite;
 
-    for (stype i = 0; i < imax; i++)
+    for (stype i = 0; i < nodes.size(); i++)
     {
-        poly = old_branch->get_segment_at(i);
-        box  = bg::return_envelope<BBox>(*(poly.get()));
+        if (neurites[i].empty())
+        {
+            continue;
+        }
+
+        if (neurite == nullptr or neurite->get_name() != neurites[i] or
+            neurite->get_parent_neuron().lock()->get_gid() != neurons[i])
+        {
+            NeuronPtr neuron = kernel().neuron_manager.get_neuron(neurons[i]);
+
+            neurite = nullptr;
 
-        // remove old version
-        info = std::make_tuple(neuron, neurite, old_id, i + branching_point);
-        remove_object(box, info, omp_id);
+            if (neuron != nullptr and neuron->is_neurite(neurites[i]))
+            {
+                neurite = neuron->get_neurite(neurites[i]).lock();
+            }
+        }
 
-        // readd, associated to new segment id
-        info = std::make_tuple(neuron, neurite, old_id, i);
-        // add polygon
-        geom_add_buffer_[omp_id][info] = poly;
-        // add box, so `true` in box buffer
-        box_buffer_[omp_id].push_back(std::make_tuple(info, box, true));
+        if (neurite != nullptr)
+        {
+            neurite->segment_key(nodes[i], segments[i]);
+        }
     }
 }
 
@@ -541,6 +828,7 @@ void SpaceManager::get_objects_in_range(const BPoint &p, double radius,
         // get the values inside the BBox
         std::vector<RtreeValue> returned_values;
         rtree_.query(bgi::intersects(box), std::back_inserter(returned_values));
+        kernel().profile_manager.count(profiling::RTREE_QUERIES);
 
         // get the associated ObjectInfo
         for (const auto &value : returned_values)
@@ -561,6 +849,7 @@ void SpaceManager::get_intersected_objects(const BPoint &start,
         BSegment s(start, stop);
         std::vector<RtreeValue> returned_values;
         rtree_.query(bgi::intersects(s), std::back_inserter(returned_values));
+        kernel().profile_manager.count(profiling::RTREE_QUERIES);
 
         // get the associated ObjectInfo
         for (const auto &value : returned_values)
@@ -582,12 +871,13 @@ void SpaceManager::get_intersected_objects(const BPoint &start,
         BSegment s(start, stop);
         std::vector<RtreeValue> returned_values;
         rtree_.query(bgi::intersects(s), std::back_inserter(returned_values));
+        kernel().profile_manager.count(profiling::RTREE_QUERIES);
 
         // get the associated ObjectInfo
         for (const auto &value : returned_values)
         {
             vi.push_back(value.second);
-            vn.push_back(map_geom_.at(value.second));
+            vn.push_back(get_polygon(map_geom_.at(value.second)));
         }
     }
 }
@@ -597,16 +887,46 @@ void SpaceManager::update_rtree()
 {
 #pragma omp single
     {
+        ProfileTimer timer(kernel().profile_manager, profiling::UPDATE_RTREE);
+
+        // when many segments are removed (e.g. large retractions), the tree
+        // is rebuilt once instead of removing them one by one
+        stype num_removals = 0;
+
+        for (const auto &v : box_buffer_)
+        {
+            for (const auto &tpl : v)
+            {
+                num_removals += not std::get<2>(tpl);
+            }
+        }
+
+        bool rebuild = num_removals >= MIN_REBUILD_REMOVALS and
+                       num_removals >= REBUILD_FRACTION * rtree_.size();
+
+        // final state of the modified entries if the tree is rebuilt
+        std::unordered_map<ObjectInfo, std::pair<BBox, bool>,
+                           boost::hash<ObjectInfo>>
+            changes;
+
+        // entries removed by the rebuild which must already be in the tree
+        // (their first operation in this update is a removal)
+        std::unordered_map<ObjectInfo, BBox, boost::hash<ObjectInfo>>
+            tree_removals;
+
+        // removed objects which are in the contact log
+        std::unordered_set<ObjectInfo, boost::hash<ObjectInfo>> removed;
+
         // box buffer is keeping track of the proper order of the addition and
         // removal operations, so we follow it
 
         for (stype i = 0; i < box_buffer_.size(); i++)
         {
-            const space_tree_map &gmap = geom_add_buffer_[i];
+            const geometry_map &gmap = geom_add_buffer_[i];
             const auto &v              = box_buffer_[i];
 
             // first loop on the OpenMP vector
-            for (const auto tpl : v)
+            for (const auto &tpl : v)
             {
                 // second loop over the operations to perform
                 const ObjectInfo &info = std::get<0>(tpl);
@@ -616,7 +936,15 @@ void SpaceManager::update_rtree()
                 if (std::get<2>(tpl))
                 {
                     // addition
-                    rtree_.insert(std::make_pair(box, info));
+                    if (rebuild)
+                    {
+                        changes[info] = std::make_pair(box, true);
+                    }
+                    else
+                    {
+                        rtree_.insert(std::make_pair(box, info));
+                    }
+
                     auto it = gmap.find(info);
 
                     if (it == gmap.end())
@@ -633,14 +961,27 @@ void SpaceManager::update_rtree()
                 else
                 {
                     // removal
-                    int rm = rtree_.remove(RtreeValue({box, info}));
+                    if (rebuild)
+                    {
+                        if (changes.find(info) == changes.end())
+                        {
+                            tree_removals.emplace(info, box);
+                        }
 
-                    if (rm == 0)
+                        changes[info] = std::make_pair(box, false);
+                    }
+                    else
                     {
-                        printf("for %lu %s %lu %lu\n", std::get<0>(info),
-                               std::get<1>(info).c_str(), std::get<2>(info),
-                               std::get<3>(info));
-                        throw std::runtime_error("removal from tree failed.");
+                        int rm = rtree_.remove(RtreeValue({box, info}));
+
+                        if (rm == 0)
+                        {
+                            printf("for %lu %s %lu %lu\n", std::get<0>(info),
+                                   std::get<1>(info).c_str(),
+                                   std::get<2>(info), std::get<3>(info));
+                            throw std::runtime_error(
+                                "removal from tree failed.");
+                        }
                     }
 
                     auto it_geom = map_geom_.find(info);
@@ -654,6 +995,11 @@ void SpaceManager::update_rtree()
                             "removal from map_geom_ failed.");
                     }
                     map_geom_.erase(it_geom);
+
+                    if (contact_objects_.find(info) != contact_objects_.end())
+                    {
+                        removed.insert(info);
+                    }
                 }
             }
 
@@ -661,6 +1007,61 @@ void SpaceManager::update_rtree()
             box_buffer_[i].clear();
             geom_add_buffer_[i].clear();
         }
+
+        if (rebuild)
+        {
+            // keep the entries that were not modified, then add the new ones
+            std::vector<RtreeValue> values;
+            values.reserve(rtree_.size() + changes.size());
+
+            rtree_.query(
+                bgi::satisfies([&changes, &tree_removals](const RtreeValue &v) {
+                    auto it = tree_removals.find(v.second);
+
+                    if (it != tree_removals.end() and
+                        bg::equals(it->second, v.first))
+                    {
+                        tree_removals.erase(it);
+                    }
+
+                    return changes.find(v.second) == changes.end();
+                }),
+                std::back_inserter(values));
+
+            // same check as for the removal of a single entry
+            if (not tree_removals.empty())
+            {
+                const ObjectInfo &info = tree_removals.begin()->first;
+
+                printf("for %lu %s %lu %lu\n", std::get<0>(info),
+                       std::get<1>(info).c_str(), std::get<2>(info),
+                       std::get<3>(info));
+                throw std::runtime_error("removal from tree failed.");
+            }
+
+            for (const auto &change : changes)
+            {
+                if (change.second.second)
+                {
+                    values.push_back({change.second.first, change.first});
+                }
+            }
+
+            rtree_ = bgi::rtree<RtreeValue, bgi::quadratic<16>>(values);
+        }
+
+        // contacts of retracted segments are removed from the log
+        if (not removed.empty())
+        {
+            purge_contact_log([&removed](const ObjectInfo &info) {
+                return removed.find(info) != removed.end();
+            });
+        }
+
+        if (track_contacts_)
+        {
+            update_contact_log();
+        }
     }
 }
 
@@ -685,7 +1086,7 @@ bool SpaceManager::sense(std::vector<double> &directions_weights,
 
     stype neuron_id                 = gc_ptr->get_neuron_id();
     const std::string &neurite_name = gc_ptr->get_neurite_name();
-    BPolygonPtr last_segment        = gc_ptr->get_branch()->get_last_segment();
+    GeometryPtr last_segment        = gc_ptr->get_branch()->get_last_geometry();
 
     double aff_self                 = aff_values.affinity_self;
     double aff_axon_same_neuron     = aff_values.affinity_axon_same_neuron;
@@ -725,6 +1126,12 @@ bool SpaceManager::sense(std::vector<double> &directions_weights,
     AreaPtr old_area  = environment_initialized_ ? areas_[area] : nullptr;
     double old_height = environment_initialized_ ? old_area->get_height() : 0.;
 
+    // walls and area borders further than the filopodia cannot be sensed
+    bool walls_in_range =
+        get_wall_distance(
+            position, kernel().parallelism_manager.get_thread_local_id()) <=
+        len_filo;
+
     // get the properties of the neighboring geometries
     std::vector<ObjectInfo> neighbors_info;
 
@@ -768,13 +1175,20 @@ bool SpaceManager::sense(std::vector<double> &directions_weights,
             // get the intersected objects
             get_intersected_objects(position, filo_pos, neighbors_info);
 
+            kernel().profile_manager.count(profiling::INTERSECTIONS,
+                                           neighbors_info.size());
+
             BPolygonPtr other;
+            GeometryPtr other_geom;
             stype other_neuron, other_node, other_segment;
             std::string other_neurite;
 
             for (const auto &info : neighbors_info)
             {
-                other         = map_geom_[info];
+                auto it_geom  = map_geom_.find(info);
+                other_geom    = it_geom == map_geom_.end() ? nullptr
+                                                           : it_geom->second;
+                other         = get_polygon(other_geom);
                 other_neuron  = std::get<0>(info);
                 other_neurite = std::get<1>(info);
                 other_node    = std::get<2>(info);
@@ -783,7 +1197,7 @@ bool SpaceManager::sense(std::vector<double> &directions_weights,
                 bool other_intersects = false;
 
                 // check for intersections
-                if (other == gc_ptr->get_last_segment())
+                if (other_geom == last_segment)
                 {
                     // ignore possible intersection with last segment
                     other_intersects = false;
@@ -945,7 +1359,7 @@ bool SpaceManager::sense(std::vector<double> &directions_weights,
 
         // intersections with areas (and indirectly with walls)
         // "recursively"
-        if (intersects(area, filo_line))
+        if (walls_in_range and intersects(area, filo_line))
         {
             interacting = true;
 
@@ -1141,56 +1555,176 @@ bool SpaceManager::sense(std::vector<double> &directions_weights,
 }
 
 
-void SpaceManager::check_accessibility(std::vector<double> &directions_weights,
-                                       const Filopodia &filopodia,
-                                       const BPoint &position, const Move &move,
-                                       const BPolygonPtr last_segment)
+/**
+ * @brief Closed-form sensing when no obstacle lies within filopodia range
+ *
+ * Conservative proximity test: if the nearest wall or area border is further
+ * than the filopodia length and no other object of the spatial index lies in
+ * the bounding box of the sensing sector (except the growth cone's own last
+ * segment), none of the filopodia can intersect anything.
+ * The affinity integral computed in :cpp:func:`SpaceManager::sense` then
+ * reduces to a constant which is set directly in `directions_weights`.
+ *
+ * @param wall_distance set to the distance to the nearest wall, which can be
+ *                      used afterwards to skip the accessibility tests.
+ *
+ * @return true if the space is free and the weights were set, false if the
+ *         full sensing is required.
+ */
+bool SpaceManager::sense_free_space(std::vector<double> &directions_weights,
+                                    const Filopodia &filopodia,
+                                    const BPoint &position, const Move &move,
+                                    double radius,
+                                    const GeometryPtr last_segment,
+                                    double &wall_distance, int omp_id) const
 {
-    unsigned int n_angle;
-    BPoint target_pos;
-    double angle;
+    double len_filo = filopodia.finger_length;
 
-    // test the environment for each of the filopodia's angles
-    //~ for (n_angle = n_min; n_angle < n_max; n_angle++)
-    for (n_angle = 0; n_angle < filopodia.size; n_angle++)
+    wall_distance = get_wall_distance(position, omp_id);
+
+    if (wall_distance <= len_filo)
     {
-        angle = move.angle + filopodia.directions.at(n_angle);
+        return false;
+    }
 
-        target_pos = BPoint(position.x() + cos(angle) * move.module,
-                            position.y() + sin(angle) * move.module);
+    if (interactions_ and not map_geom_.empty())
+    {
+        // bounding box of the sector spanned by the filopodia
+        auto minmax = std::minmax_element(filopodia.directions.begin(),
+                                          filopodia.directions.end());
 
-        const BLineString &line = line_from_points(position, target_pos);
+        double a_min(move.angle + *minmax.first),
+            a_max(move.angle + *minmax.second);
+        double x0(position.x()), y0(position.y());
+        double xmin(x0), xmax(x0), ymin(y0), ymax(y0);
 
-        if (intersects("environment", line))
+        if (a_max - a_min >= 2 * M_PI)
         {
-            directions_weights[n_angle] = std::nan(""); // cannot escape env
+            xmin -= len_filo;
+            xmax += len_filo;
+            ymin -= len_filo;
+            ymax += len_filo;
         }
-        else if (last_segment != nullptr and
-                 bg::covered_by(target_pos, *(last_segment.get())))
+        else
         {
-            directions_weights[n_angle] = std::nan(""); // cannot cross oneself
+            std::vector<double> angles({a_min, a_max});
+
+            // add the extremal points of the arc along the axes
+            for (double k = std::ceil(a_min / (0.5 * M_PI));
+                 k * 0.5 * M_PI <= a_max; k++)
+            {
+                angles.push_back(k * 0.5 * M_PI);
+            }
+
+            for (double angle : angles)
+            {
+                xmin = std::min(xmin, x0 + len_filo * cos(angle));
+                xmax = std::max(xmax, x0 + len_filo * cos(angle));
+                ymin = std::min(ymin, y0 + len_filo * sin(angle));
+                ymax = std::max(ymax, y0 + len_filo * sin(angle));
+            }
         }
-    }
-}
 
+        BBox box(BPoint(xmin, ymin), BPoint(xmax, ymax));
 
-void SpaceManager::check_synaptic_site(const BPoint &position, double distance,
-                                       stype neuron_id,
-                                       const std::string &neurite_name,
-                                       stype other_neuron,
-                                       const std::string &other_neurite,
-                                       BPolygonPtr poly)
-{
-    if (distance < max_syn_distance_)
-    {
-        if (neurite_name == "axon" or other_neurite == "axon")
+        std::vector<RtreeValue> returned_values;
+        rtree_.query(bgi::intersects(box), std::back_inserter(returned_values));
+        kernel().profile_manager.count(profiling::RTREE_QUERIES);
+
+        for (const auto &value : returned_values)
         {
-#pragma omp single
+            auto it = map_geom_.find(value.second);
+
+            // the last segment is ignored by `sense`
+            if (it == map_geom_.end() or it->second != last_segment)
             {
-                if (not bg::within(position, known_synaptic_sites_))
-                {
-                    if (bg::within(position, *(poly.get())))
-                    {
+                return false;
+            }
+        }
+    }
+
+    // no intersection: affinity integral of `sense` over the substrate only
+    double lamel_factor = 2.;
+    double affinity     = filopodia.substrate_affinity;
+
+    if (len_filo <= radius)
+    {
+        affinity *= lamel_factor;
+    }
+    else
+    {
+        affinity *= 0.5 * (lamel_factor + 1.);
+    }
+
+    affinity = std::max(affinity, 0.);
+
+    std::fill(directions_weights.begin(),
+              directions_weights.begin() + filopodia.size, affinity);
+
+    return true;
+}
+
+
+/**
+ * @brief Forbid directions which would exit the environment or cross oneself
+ *
+ * @param wall_distance known distance to the nearest wall, the environment
+ *                      test is skipped if the move is shorter.
+ */
+void SpaceManager::check_accessibility(std::vector<double> &directions_weights,
+                                       const Filopodia &filopodia,
+                                       const BPoint &position, const Move &move,
+                                       const BPolygonPtr last_segment,
+                                       double wall_distance)
+{
+    unsigned int n_angle;
+    BPoint target_pos;
+    double angle;
+
+    // the move cannot reach any wall
+    bool env_check = move.module >= wall_distance;
+
+    // test the environment for each of the filopodia's angles
+    //~ for (n_angle = n_min; n_angle < n_max; n_angle++)
+    for (n_angle = 0; n_angle < filopodia.size; n_angle++)
+    {
+        angle = move.angle + filopodia.directions.at(n_angle);
+
+        target_pos = BPoint(position.x() + cos(angle) * move.module,
+                            position.y() + sin(angle) * move.module);
+
+        const BLineString &line = line_from_points(position, target_pos);
+
+        if (env_check and intersects("environment", line))
+        {
+            directions_weights[n_angle] = std::nan(""); // cannot escape env
+        }
+        else if (last_segment != nullptr and
+                 bg::covered_by(target_pos, *(last_segment.get())))
+        {
+            directions_weights[n_angle] = std::nan(""); // cannot cross oneself
+        }
+    }
+}
+
+
+void SpaceManager::check_synaptic_site(const BPoint &position, double distance,
+                                       stype neuron_id,
+                                       const std::string &neurite_name,
+                                       stype other_neuron,
+                                       const std::string &other_neurite,
+                                       BPolygonPtr poly)
+{
+    if (distance < max_syn_distance_)
+    {
+        if (neurite_name == "axon" or other_neurite == "axon")
+        {
+#pragma omp single
+            {
+                if (not bg::within(position, known_synaptic_sites_))
+                {
+                    if (bg::within(position, *(poly.get())))
+                    {
                         new_potential_synapse_crossing_.push_back(position);
                     }
                     else
@@ -1214,356 +1748,1060 @@ void SpaceManager::check_synaptic_site(const BPoint &position, double distance,
                     box.outer().push_back(
                         BPoint(x - max_syn_distance_, y - max_syn_distance_));
 
-                    known_synaptic_sites_.push_back(box);
-                }
+                    known_synaptic_sites_.push_back(box);
+                }
+            }
+        }
+    }
+}
+
+
+/**
+ * @brief Append one synapse to the buffer.
+ */
+void SynapseBuffer::add_synapse(const ObjectInfo &pre, const ObjectInfo &post,
+                                const BPoint &pre_pos, const BPoint &post_pos)
+{
+    presyn_neurons.push_back(std::get<0>(pre));
+    presyn_neurites.push_back(std::get<1>(pre));
+    presyn_nodes.push_back(std::get<2>(pre));
+    presyn_segments.push_back(std::get<3>(pre));
+
+    postsyn_neurons.push_back(std::get<0>(post));
+    postsyn_neurites.push_back(std::get<1>(post));
+    postsyn_nodes.push_back(std::get<2>(post));
+    postsyn_segments.push_back(std::get<3>(post));
+
+    pre_syn_x.push_back(pre_pos.x());
+    pre_syn_y.push_back(pre_pos.y());
+    post_syn_x.push_back(post_pos.x());
+    post_syn_y.push_back(post_pos.y());
+}
+
+
+stype SynapseBuffer::size() const { return presyn_neurons.size(); }
+
+
+/**
+ * @brief Copy one column of each buffer into `out`, starting at the
+ * precomputed offsets.
+ */
+template <typename Buffer, typename T>
+void concatenate_column(const std::vector<Buffer> &buffers,
+                        std::vector<T> Buffer::*column,
+                        const std::vector<stype> &offsets, std::vector<T> &out)
+{
+    out.resize(offsets.back());
+
+#pragma omp parallel for schedule(static)
+    for (long b = 0; b < static_cast<long>(buffers.size()); b++)
+    {
+        const std::vector<T> &values = buffers[b].*column;
+        std::copy(values.begin(), values.end(), out.begin() + offsets[b]);
+    }
+}
+
+
+/**
+ * @brief Concatenate the buffers, in order, at the end of the output tables.
+ */
+void merge_synapse_buffers(
+    const std::vector<SynapseBuffer> &buffers,
+    std::vector<stype> &presyn_neurons, std::vector<stype> &postsyn_neurons,
+    std::vector<std::string> &presyn_neurites,
+    std::vector<std::string> &postsyn_neurites,
+    std::vector<stype> &presyn_nodes, std::vector<stype> &postsyn_nodes,
+    std::vector<stype> &presyn_segments, std::vector<stype> &postsyn_segments,
+    std::vector<double> &pre_syn_x, std::vector<double> &pre_syn_y,
+    std::vector<double> &post_syn_x, std::vector<double> &post_syn_y)
+{
+    // prefix sum of the buffer sizes gives the position of each buffer
+    std::vector<stype> offsets(buffers.size() + 1, presyn_neurons.size());
+
+    for (stype b = 0; b < buffers.size(); b++)
+    {
+        offsets[b + 1] = offsets[b] + buffers[b].size();
+    }
+
+    concatenate_column(buffers, &SynapseBuffer::presyn_neurons, offsets,
+                       presyn_neurons);
+    concatenate_column(buffers, &SynapseBuffer::postsyn_neurons, offsets,
+                       postsyn_neurons);
+    concatenate_column(buffers, &SynapseBuffer::presyn_neurites, offsets,
+                       presyn_neurites);
+    concatenate_column(buffers, &SynapseBuffer::postsyn_neurites, offsets,
+                       postsyn_neurites);
+    concatenate_column(buffers, &SynapseBuffer::presyn_nodes, offsets,
+                       presyn_nodes);
+    concatenate_column(buffers, &SynapseBuffer::postsyn_nodes, offsets,
+                       postsyn_nodes);
+    concatenate_column(buffers, &SynapseBuffer::presyn_segments, offsets,
+                       presyn_segments);
+    concatenate_column(buffers, &SynapseBuffer::postsyn_segments, offsets,
+                       postsyn_segments);
+    concatenate_column(buffers, &SynapseBuffer::pre_syn_x, offsets, pre_syn_x);
+    concatenate_column(buffers, &SynapseBuffer::pre_syn_y, offsets, pre_syn_y);
+    concatenate_column(buffers, &SynapseBuffer::post_syn_x, offsets,
+                       post_syn_x);
+    concatenate_column(buffers, &SynapseBuffer::post_syn_y, offsets,
+                       post_syn_y);
+}
+
+
+/*
+ * Test all crossing to generate synapses.
+ */
+void SpaceManager::generate_synapses_crossings(
+    double synapse_density, bool only_new_syn, bool autapse_allowed,
+    bool deterministic, const std::set<stype> &presyn_pop,
+    const std::set<stype> &postsyn_pop, std::vector<stype> &presyn_neurons,
+    std::vector<stype> &postsyn_neurons,
+    std::vector<std::string> &presyn_neurites,
+    std::vector<std::string> &postsyn_neurites,
+    std::vector<stype> &presyn_nodes, std::vector<stype> &postsyn_nodes,
+    std::vector<stype> &presyn_segments, std::vector<stype> &postsyn_segments,
+    std::vector<double> &pre_syn_x, std::vector<double> &pre_syn_y,
+    std::vector<double> &post_syn_x, std::vector<double> &post_syn_y)
+{
+    // sites to test
+    std::vector<BPoint> points(new_potential_synapse_crossing_);
+
+    if (not only_new_syn)
+    {
+        points.insert(points.end(), old_potential_synapse_crossing_.begin(),
+                      old_potential_synapse_crossing_.end());
+    }
+
+    std::vector<SynapseBuffer> buffers;
+
+    detect_synapses(points, true, synapse_density, autapse_allowed,
+                    deterministic, presyn_pop, postsyn_pop, buffers);
+
+    stype start = presyn_neurons.size();
+
+    merge_synapse_buffers(buffers, presyn_neurons, postsyn_neurons,
+                          presyn_neurites, postsyn_neurites, presyn_nodes,
+                          postsyn_nodes, presyn_segments, postsyn_segments,
+                          pre_syn_x, pre_syn_y, post_syn_x, post_syn_y);
+
+    segment_positions(presyn_neurons, presyn_neurites, presyn_nodes,
+                      presyn_segments, start);
+    segment_positions(postsyn_neurons, postsyn_neurites, postsyn_nodes,
+                      postsyn_segments, start);
+
+    // move the new potential sites to the old container and clear it
+
+    old_potential_synapse_crossing_.insert(
+        old_potential_synapse_crossing_.end(),
+        new_potential_synapse_crossing_.begin(),
+        new_potential_synapse_crossing_.end());
+
+    new_potential_synapse_crossing_.clear();
+}
+
+
+void SpaceManager::generate_synapses_all(
+    double spine_density, bool only_new_syn, bool autapse_allowed,
+    bool deterministic, const std::set<stype> &presyn_pop,
+    const std::set<stype> &postsyn_pop, std::vector<stype> &presyn_neurons,
+    std::vector<stype> &postsyn_neurons,
+    std::vector<std::string> &presyn_neurites,
+    std::vector<std::string> &postsyn_neurites,
+    std::vector<stype> &presyn_nodes, std::vector<stype> &postsyn_nodes,
+    std::vector<stype> &presyn_segments, std::vector<stype> &postsyn_segments,
+    std::vector<double> &pre_syn_x, std::vector<double> &pre_syn_y,
+    std::vector<double> &post_syn_x, std::vector<double> &post_syn_y)
+{
+    // sites to test: crossings then near sites, new ones first
+    std::vector<BPoint> points(new_potential_synapse_crossing_);
+
+    if (not only_new_syn)
+    {
+        points.insert(points.end(), old_potential_synapse_crossing_.begin(),
+                      old_potential_synapse_crossing_.end());
+    }
+
+    points.insert(points.end(), new_potential_synapse_near_.begin(),
+                  new_potential_synapse_near_.end());
+
+    if (not only_new_syn)
+    {
+        points.insert(points.end(), old_potential_synapse_near_.begin(),
+                      old_potential_synapse_near_.end());
+    }
+
+    std::vector<SynapseBuffer> buffers;
+
+    detect_synapses(points, false, spine_density, autapse_allowed,
+                    deterministic, presyn_pop, postsyn_pop, buffers);
+
+    stype start = presyn_neurons.size();
+
+    merge_synapse_buffers(buffers, presyn_neurons, postsyn_neurons,
+                          presyn_neurites, postsyn_neurites, presyn_nodes,
+                          postsyn_nodes, presyn_segments, postsyn_segments,
+                          pre_syn_x, pre_syn_y, post_syn_x, post_syn_y);
+
+    segment_positions(presyn_neurons, presyn_neurites, presyn_nodes,
+                      presyn_segments, start);
+    segment_positions(postsyn_neurons, postsyn_neurites, postsyn_nodes,
+                      postsyn_segments, start);
+
+    // move the new potential sites to the old container and clear it
+
+    old_potential_synapse_crossing_.insert(
+        old_potential_synapse_crossing_.end(),
+        new_potential_synapse_crossing_.begin(),
+        new_potential_synapse_crossing_.end());
+
+    new_potential_synapse_crossing_.clear();
+
+    old_potential_synapse_near_.insert(old_potential_synapse_near_.end(),
+                                       new_potential_synapse_near_.begin(),
+                                       new_potential_synapse_near_.end());
+
+    new_potential_synapse_near_.clear();
+}
+
+
+/**
+ * @brief Parallel pass over the potential synaptic sites.
+ *
+ * Sites are split into chunks of SYNAPSE_CHUNK_SIZE points which are
+ * dynamically distributed among the threads.
+ * By default, each thread fills its own buffer using its own RNG, so the
+ * order of the synapses depends on the scheduling.
+ * If `deterministic` is true, each chunk gets its own buffer and its own RNG,
+ * seeded from the master RNG and the chunk index, so that the result does
+ * not depend on the number of threads.
+ */
+void SpaceManager::detect_synapses(const std::vector<BPoint> &points,
+                                   bool crossings_only, double density,
+                                   bool autapse_allowed, bool deterministic,
+                                   const std::set<stype> &presyn_pop,
+                                   const std::set<stype> &postsyn_pop,
+                                   std::vector<SynapseBuffer> &buffers) const
+{
+    stype num_points = points.size();
+    stype num_chunks =
+        (num_points + SYNAPSE_CHUNK_SIZE - 1) / SYNAPSE_CHUNK_SIZE;
+
+    int num_omp = kernel().parallelism_manager.get_num_local_threads();
+
+    buffers = std::vector<SynapseBuffer>(deterministic ? num_chunks : num_omp);
+
+    unsigned int base_seed = 0;
+
+    if (deterministic)
+    {
+        base_seed = (*(kernel().rng_manager.get_rng(0).get()))();
+    }
+
+#pragma omp parallel
+    {
+        int omp_id = kernel().parallelism_manager.get_thread_local_id();
+        mtPtr rng  = kernel().rng_manager.get_rng(omp_id);
+        std::mt19937 chunk_rng;
+        dilated_segment_map dilated;
+
+#pragma omp for schedule(dynamic)
+        for (long c = 0; c < static_cast<long>(num_chunks); c++)
+        {
+            stype start = c * SYNAPSE_CHUNK_SIZE;
+            stype stop  = std::min(start + SYNAPSE_CHUNK_SIZE, num_points);
+
+            if (deterministic)
+            {
+                std::seed_seq seq{base_seed, static_cast<unsigned int>(c)};
+                chunk_rng.seed(seq);
+            }
+
+            std::mt19937 &gen     = deterministic ? chunk_rng : *(rng.get());
+            SynapseBuffer &buffer = buffers[deterministic ? c : omp_id];
+
+            for (stype k = start; k < stop; k++)
+            {
+                synapses_at_site(points[k], crossings_only, density,
+                                 autapse_allowed, presyn_pop, postsyn_pop, gen,
+                                 dilated, buffer);
+            }
+        }
+    }
+}
+
+
+/**
+ * @brief Generate the synapses between the axons and the other neurites
+ * around a potential synaptic site.
+ *
+ * If `crossings_only` is true, synapses are generated from the intersection
+ * of the segments, otherwise from the intersection of the segments dilated
+ * by half of `max_syn_distance_`.
+ */
+void SpaceManager::synapses_at_site(const BPoint &p, bool crossings_only,
+                                    double density, bool autapse_allowed,
+                                    const std::set<stype> &presyn_pop,
+                                    const std::set<stype> &postsyn_pop,
+                                    std::mt19937 &rng,
+                                    dilated_segment_map &dilated,
+                                    SynapseBuffer &buffer) const
+{
+    std::uniform_real_distribution<double> uniform(0., 1.);
+
+    // get the properties of the neighboring geometries
+    std::vector<ObjectInfo> neighbors_info;
+    get_objects_in_range(p, max_syn_distance_, neighbors_info);
+
+    // separate axons from dendrites and somas
+    std::vector<stype> axons, others;
+
+    for (stype i = 0; i < neighbors_info.size(); i++)
+    {
+        if (std::get<1>(neighbors_info[i]) == "axon")
+        {
+            axons.push_back(i);
+        }
+        else
+        {
+            others.push_back(i);
+        }
+    }
+
+    if (axons.empty() or others.empty())
+    {
+        return;
+    }
+
+    BMultiPolygon intersection;
+    BPoint pre_pos, post_pos;
+    int num_synapses;
+    double tmp, area;
+
+    for (stype i : axons)
+    {
+        const ObjectInfo &axon_info = neighbors_info[i];
+        stype presyn_id             = std::get<0>(axon_info);
+
+        if (presyn_pop.find(presyn_id) == presyn_pop.end())
+        {
+            continue;
+        }
+
+        BPolygonPtr axon_segment = get_polygon(map_geom_.at(axon_info));
+
+        for (stype j : others)
+        {
+            const ObjectInfo &other_info = neighbors_info[j];
+            stype postsyn_id             = std::get<0>(other_info);
+
+            if (postsyn_pop.find(postsyn_id) == postsyn_pop.end() or
+                (presyn_id == postsyn_id and not autapse_allowed))
+            {
+                continue;
+            }
+
+            // these two are eligible for synapse creation, test for the
+            // existence of a synapse
+            BPolygonPtr other_segment = get_polygon(map_geom_.at(other_info));
+
+            intersection.clear();
+
+            if (crossings_only)
+            {
+                if (not bg::intersects(*(axon_segment.get()),
+                                       *(other_segment.get())))
+                {
+                    continue;
+                }
+
+                bg::intersection(*(axon_segment.get()),
+                                 *(other_segment.get()), intersection);
+            }
+            else
+            {
+                const BPolygon &axon_buffer = get_dilated_segment(
+                    axon_info, 0.5 * max_syn_distance_, dilated);
+                const BPolygon &other_buffer = get_dilated_segment(
+                    other_info, 0.5 * max_syn_distance_, dilated);
+
+                if (not bg::intersects(axon_buffer, other_buffer))
+                {
+                    continue;
+                }
+
+                bg::intersection(axon_buffer, other_buffer, intersection);
+            }
+
+            area = bg::area(intersection);
+
+            tmp          = area * density;
+            num_synapses = tmp;
+
+            if (tmp - num_synapses > uniform(rng))
+            {
+                num_synapses += 1;
+            }
+
+            if (num_synapses == 0)
+            {
+                continue;
+            }
+
+            // @todo get random points in the intersection or along the
+            // segments
+            if (crossings_only)
+            {
+                bg::centroid(intersection, pre_pos);
+                post_pos = pre_pos;
+            }
+            else
+            {
+                bg::centroid(*(axon_segment.get()), pre_pos);
+                bg::centroid(*(other_segment.get()), post_pos);
+            }
+
+            for (int s = 0; s < num_synapses; s++)
+            {
+                buffer.add_synapse(axon_info, other_info, pre_pos, post_pos);
+            }
+        }
+    }
+}
+
+
+/**
+ * @brief Segment polygon dilated by `distance`, memoised in `cache`.
+ *
+ * A given cache must always be used with the same `distance`.
+ */
+const BPolygon &
+SpaceManager::get_dilated_segment(const ObjectInfo &info, double distance,
+                                  dilated_segment_map &cache) const
+{
+    auto it = cache.find(info);
+
+    if (it == cache.end())
+    {
+        BMultiPolygon geom;
+
+        bg::strategy::buffer::distance_symmetric<double> distance_strategy(
+            distance);
+
+        bg::buffer(*(get_polygon(map_geom_.at(info)).get()), geom,
+                   distance_strategy, side_strategy_, join_strategy_,
+                   end_strategy_, circle_strategy_);
+
+        it = cache.emplace(info, geom[0]).first;
+    }
+
+    return it->second;
+}
+
+
+/**
+ * @brief Union of the polygons of `segments`, dilated by `distance` if it
+ * is not zero; segments which are no longer in the R-tree are ignored.
+ */
+void SpaceManager::segment_union(const std::set<ObjectInfo> &segments,
+                                 double distance, dilated_segment_map &cache,
+                                 BMultiPolygon &geom) const
+{
+    BMultiPolygon tmp;
+
+    geom.clear();
+
+    for (const ObjectInfo &info : segments)
+    {
+        auto it = map_geom_.find(info);
+
+        if (it == map_geom_.end())
+        {
+            continue;
+        }
+
+        tmp.clear();
+
+        if (distance > 0)
+        {
+            bg::union_(geom, get_dilated_segment(info, distance, cache), tmp);
+        }
+        else
+        {
+            bg::union_(geom, *(get_polygon(it->second).get()), tmp);
+        }
+
+        geom.swap(tmp);
+    }
+}
+
+
+/**
+ * @brief Append one contact to the buffer.
+ */
+void ContactBuffer::add_contact(const ObjectInfo &pre, const ObjectInfo &post,
+                                double area, const BPoint &position)
+{
+    presyn_neurons.push_back(std::get<0>(pre));
+    presyn_neurites.push_back(std::get<1>(pre));
+    presyn_nodes.push_back(std::get<2>(pre));
+    presyn_segments.push_back(std::get<3>(pre));
+
+    postsyn_neurons.push_back(std::get<0>(post));
+    postsyn_neurites.push_back(std::get<1>(post));
+    postsyn_nodes.push_back(std::get<2>(post));
+    postsyn_segments.push_back(std::get<3>(post));
+
+    contact_area.push_back(area);
+    contact_x.push_back(position.x());
+    contact_y.push_back(position.y());
+}
+
+
+ObjectInfo ContactBuffer::presyn(stype i) const
+{
+    return std::make_tuple(presyn_neurons[i], presyn_neurites[i],
+                           presyn_nodes[i], presyn_segments[i]);
+}
+
+
+ObjectInfo ContactBuffer::postsyn(stype i) const
+{
+    return std::make_tuple(postsyn_neurons[i], postsyn_neurites[i],
+                           postsyn_nodes[i], postsyn_segments[i]);
+}
+
+
+stype ContactBuffer::size() const { return presyn_neurons.size(); }
+
+
+/**
+ * @brief All the contacts between the axons of `presyn_pop` and the
+ * dendrites or somas of `postsyn_pop`.
+ *
+ * The contacts are obtained by a self-join of the R-tree: each axon segment
+ * (broad phase) queries the segments whose bounding box intersects its own,
+ * enlarged by `max_distance`; then (narrow phase) the overlap of the two
+ * segments is computed, after dilating both of them by half of
+ * `max_distance` if it is not zero.
+ * Each contact comes with the area of the overlap and its centroid.
+ *
+ * Axon segments are processed in order, by chunks, so the contacts are
+ * always returned in the same order.
+ */
+void SpaceManager::get_contacts(
+    double max_distance, bool autapse_allowed,
+    const std::set<stype> &presyn_pop, const std::set<stype> &postsyn_pop,
+    std::vector<stype> &presyn_neurons, std::vector<stype> &postsyn_neurons,
+    std::vector<std::string> &presyn_neurites,
+    std::vector<std::string> &postsyn_neurites,
+    std::vector<stype> &presyn_nodes, std::vector<stype> &postsyn_nodes,
+    std::vector<stype> &presyn_segments, std::vector<stype> &postsyn_segments,
+    std::vector<double> &contact_area, std::vector<double> &contact_x,
+    std::vector<double> &contact_y) const
+{
+    // axon segments of the presynaptic neurons
+    std::vector<RtreeValue> axons;
+
+    for (auto it = rtree_.begin(); it != rtree_.end(); it++)
+    {
+        const ObjectInfo &info = it->second;
+
+        if (std::get<1>(info) == "axon" and
+            presyn_pop.find(std::get<0>(info)) != presyn_pop.end())
+        {
+            axons.push_back(*it);
+        }
+    }
+
+    std::sort(axons.begin(), axons.end(),
+              [](const RtreeValue &lhs, const RtreeValue &rhs) {
+                  return lhs.second < rhs.second;
+              });
+
+    stype num_axons = axons.size();
+    stype num_chunks =
+        (num_axons + SYNAPSE_CHUNK_SIZE - 1) / SYNAPSE_CHUNK_SIZE;
+
+    std::vector<ContactBuffer> buffers(num_chunks);
+
+#pragma omp parallel
+    {
+        std::vector<RtreeValue> neighbors;
+        dilated_segment_map dilated;
+        BMultiPolygon intersection;
+        BPoint centroid;
+        double area;
+
+#pragma omp for schedule(dynamic)
+        for (long c = 0; c < static_cast<long>(num_chunks); c++)
+        {
+            stype start = c * SYNAPSE_CHUNK_SIZE;
+            stype stop  = std::min(start + SYNAPSE_CHUNK_SIZE, num_axons);
+
+            ContactBuffer &buffer = buffers[c];
+
+            for (stype k = start; k < stop; k++)
+            {
+                const ObjectInfo &axon_info = axons[k].second;
+                stype presyn_id             = std::get<0>(axon_info);
+
+                // broad phase
+                BBox box(axons[k].first);
+
+                bg::add_value(box.min_corner(), -max_distance);
+                bg::add_value(box.max_corner(), max_distance);
+
+                neighbors.clear();
+                rtree_.query(
+                    bgi::intersects(box) and
+                        bgi::satisfies([&](const RtreeValue &v) {
+                            stype postsyn_id = std::get<0>(v.second);
+
+                            return std::get<1>(v.second) != "axon" and
+                                   postsyn_pop.find(postsyn_id) !=
+                                       postsyn_pop.end() and
+                                   (autapse_allowed or presyn_id != postsyn_id);
+                        }),
+                    std::back_inserter(neighbors));
+
+                if (neighbors.empty())
+                {
+                    continue;
+                }
+
+                // narrow phase
+                BPolygonPtr axon_segment = get_polygon(map_geom_.at(axon_info));
+
+                for (const auto &other : neighbors)
+                {
+                    BPolygonPtr other_segment =
+                        get_polygon(map_geom_.at(other.second));
+
+                    intersection.clear();
+
+                    if (max_distance > 0)
+                    {
+                        const BPolygon &axon_buffer = get_dilated_segment(
+                            axon_info, 0.5 * max_distance, dilated);
+                        const BPolygon &other_buffer = get_dilated_segment(
+                            other.second, 0.5 * max_distance, dilated);
+
+                        if (not bg::intersects(axon_buffer, other_buffer))
+                        {
+                            continue;
+                        }
+
+                        bg::intersection(axon_buffer, other_buffer,
+                                         intersection);
+                    }
+                    else
+                    {
+                        if (not bg::intersects(*(axon_segment.get()),
+                                               *(other_segment.get())))
+                        {
+                            continue;
+                        }
+
+                        bg::intersection(*(axon_segment.get()),
+                                         *(other_segment.get()), intersection);
+                    }
+
+                    area = bg::area(intersection);
+
+                    if (area > 0)
+                    {
+                        bg::centroid(intersection, centroid);
+                        buffer.add_contact(axon_info, other.second, area,
+                                           centroid);
+                    }
+                }
+            }
+        }
+    }
+
+    // concatenate the chunks
+    std::vector<stype> offsets(num_chunks + 1, presyn_neurons.size());
+
+    for (stype c = 0; c < num_chunks; c++)
+    {
+        offsets[c + 1] = offsets[c] + buffers[c].size();
+    }
+
+    concatenate_column(buffers, &ContactBuffer::presyn_neurons, offsets,
+                       presyn_neurons);
+    concatenate_column(buffers, &ContactBuffer::postsyn_neurons, offsets,
+                       postsyn_neurons);
+    concatenate_column(buffers, &ContactBuffer::presyn_neurites, offsets,
+                       presyn_neurites);
+    concatenate_column(buffers, &ContactBuffer::postsyn_neurites, offsets,
+                       postsyn_neurites);
+    concatenate_column(buffers, &ContactBuffer::presyn_nodes, offsets,
+                       presyn_nodes);
+    concatenate_column(buffers, &ContactBuffer::postsyn_nodes, offsets,
+                       postsyn_nodes);
+    concatenate_column(buffers, &ContactBuffer::presyn_segments, offsets,
+                       presyn_segments);
+    concatenate_column(buffers, &ContactBuffer::postsyn_segments, offsets,
+                       postsyn_segments);
+    concatenate_column(buffers, &ContactBuffer::contact_area, offsets,
+                       contact_area);
+    concatenate_column(buffers, &ContactBuffer::contact_x, offsets,
+                       contact_x);
+    concatenate_column(buffers, &ContactBuffer::contact_y, offsets,
+                       contact_y);
+
+    segment_positions(presyn_neurons, presyn_neurites, presyn_nodes,
+                      presyn_segments, offsets[0]);
+    segment_positions(postsyn_neurons, postsyn_neurites, postsyn_nodes,
+                      postsyn_segments, offsets[0]);
+}
+
+
+/**
+ * @brief Add the contact between two overlapping segments, the axon being
+ * the presynaptic side.
+ */
+void add_overlap_contact(const ObjectInfo &info, const BPolygon &poly,
+                         const ObjectInfo &other_info,
+                         const BPolygon &other_poly, ContactBuffer &buffer)
+{
+    if (bg::intersects(poly, other_poly))
+    {
+        BMultiPolygon intersection;
+        bg::intersection(poly, other_poly, intersection);
+
+        double area = bg::area(intersection);
+
+        if (area > 0)
+        {
+            BPoint centroid;
+            bg::centroid(intersection, centroid);
+
+            if (std::get<1>(info) == "axon")
+            {
+                buffer.add_contact(info, other_info, area, centroid);
+            }
+            else
+            {
+                buffer.add_contact(other_info, info, area, centroid);
             }
         }
     }
 }
 
 
-/*
- * Test all crossing to generate synapses.
+/**
+ * @brief Find the contacts between a new segment and the segments already
+ * in the R-tree (axon with dendrite or soma).
+ *
+ * Called from `add_object`, while the R-tree is not modified; contacts
+ * between segments added during the same step are found by
+ * `update_contact_log`.
  */
-void SpaceManager::generate_synapses_crossings(
-    double synapse_density, bool only_new_syn, bool autapse_allowed,
-    const std::set<stype> &presyn_pop, const std::set<stype> &postsyn_pop,
-    std::vector<stype> &presyn_neurons, std::vector<stype> &postsyn_neurons,
-    std::vector<std::string> &presyn_neurites,
-    std::vector<std::string> &postsyn_neurites,
-    std::vector<stype> &presyn_nodes, std::vector<stype> &postsyn_nodes,
-    std::vector<stype> &presyn_segments, std::vector<stype> &postsyn_segments,
-    std::vector<double> &pre_syn_x, std::vector<double> &pre_syn_y)
+void SpaceManager::record_contacts(const ObjectInfo &info,
+                                   const BPolygon &poly, const BBox &box,
+                                   int omp_id)
 {
-    // range of points to test
-    std::vector<BPoint> &old_vec = old_potential_synapse_crossing_;
+    bool is_axon = (std::get<1>(info) == "axon");
 
-    if (only_new_syn)
-    {
-        old_vec = std::vector<BPoint>();
-    }
+    std::vector<RtreeValue> neighbors;
 
-    point_range points =
-        boost::range::join(new_potential_synapse_crossing_, old_vec);
+    rtree_.query(bgi::intersects(box) and
+                     bgi::satisfies([is_axon](const RtreeValue &v) {
+                         return (std::get<1>(v.second) == "axon") != is_axon;
+                     }),
+                 std::back_inserter(neighbors));
 
-#pragma omp parallel
+    kernel().profile_manager.count(profiling::RTREE_QUERIES);
+
+    for (const auto &other : neighbors)
     {
-        int omp_id = kernel().parallelism_manager.get_thread_local_id();
-        mtPtr rng  = kernel().rng_manager.get_rng(omp_id);
+        add_overlap_contact(info, poly, other.second,
+                            *(get_polygon(map_geom_.at(other.second)).get()),
+                            new_contacts_[omp_id]);
+    }
 
-        // store the axons and dendrites in a map
-        std::unordered_map<std::string, std::vector<stype>> ntypes(
-            {{"axon", {}}, {"other", {}}});
+    new_segments_[omp_id].push_back(std::make_pair(box, info));
+}
 
-        ObjectInfo segment_info, axon_info, other_info;
-        BMultiPolygon intersection, covered_range;
-        std::vector<ObjectInfo> neighbors_info;
-        stype presyn_id, postsyn_id;
-        bool check_syn, valid_syn;
-        double tmp, area, x, y;
-        BPoint centroid, p;
-        int num_synapses;
 
-        for (stype k = 0; k < points.size(); k++)
-        {
-            p = points[k];
+/**
+ * @brief Append the elements of `in` from index `start` at the end of `out`.
+ */
+template <typename T>
+void append_range(const std::vector<T> &in, stype start, std::vector<T> &out)
+{
+    out.insert(out.end(), in.begin() + start, in.end());
+}
 
-            // get the properties of the neighboring geometries
-            neighbors_info.clear();
-            get_objects_in_range(p, max_syn_distance_, neighbors_info);
 
-            BPolygonPtr axon_poly, other_poly;
-            ntypes.clear();
+/**
+ * @brief Append all the contacts of `in` from index `start` to `out`.
+ */
+void append_contacts(const ContactBuffer &in, stype start, ContactBuffer &out)
+{
+    append_range(in.presyn_neurons, start, out.presyn_neurons);
+    append_range(in.postsyn_neurons, start, out.postsyn_neurons);
+    append_range(in.presyn_neurites, start, out.presyn_neurites);
+    append_range(in.postsyn_neurites, start, out.postsyn_neurites);
+    append_range(in.presyn_nodes, start, out.presyn_nodes);
+    append_range(in.postsyn_nodes, start, out.postsyn_nodes);
+    append_range(in.presyn_segments, start, out.presyn_segments);
+    append_range(in.postsyn_segments, start, out.postsyn_segments);
+    append_range(in.contact_area, start, out.contact_area);
+    append_range(in.contact_x, start, out.contact_x);
+    append_range(in.contact_y, start, out.contact_y);
+}
 
-            for (stype i = 0; i < neighbors_info.size(); i++)
-            {
-                segment_info = neighbors_info[i];
 
-                if (std::get<1>(segment_info) == "axon")
-                {
-                    ntypes["axon"].push_back(i);
-                }
-                else
-                {
-                    ntypes["other"].push_back(i);
-                }
-            }
+/**
+ * @brief Append the contacts found during the step to the contact log.
+ *
+ * Called once the new segments are in the R-tree; also checks the new
+ * segments against each other.
+ */
+void SpaceManager::update_contact_log()
+{
+    // contacts with older segments, in thread order
+    ContactBuffer step_contacts;
+    std::vector<RtreeValue> step_segments;
 
-            if (ntypes["other"].size() > 0 and ntypes["axon"].size() > 0)
-            {
-                for (stype i : ntypes["axon"])
-                {
-                    axon_info = neighbors_info[i];
+    for (stype i = 0; i < new_contacts_.size(); i++)
+    {
+        append_contacts(new_contacts_[i], 0, step_contacts);
+        append_range(new_segments_[i], 0, step_segments);
 
-                    for (stype j : ntypes["other"])
-                    {
-                        // clear intersection
-                        intersection.clear();
+        new_contacts_[i] = ContactBuffer();
+        new_segments_[i].clear();
+    }
 
-                        other_info = neighbors_info[j];
+    // contacts between new segments, found from the axon side only; segments
+    // removed during the step are ignored
+    bgi::rtree<RtreeValue, bgi::quadratic<16>> step_tree(step_segments);
+    std::vector<RtreeValue> neighbors;
 
-                        presyn_id  = std::get<0>(axon_info);
-                        postsyn_id = std::get<0>(other_info);
+    for (const auto &value : step_segments)
+    {
+        auto it = map_geom_.find(value.second);
 
-                        check_syn =
-                            (presyn_pop.find(presyn_id) != presyn_pop.end()) and
-                            (postsyn_pop.find(presyn_id) != postsyn_pop.end());
+        if (std::get<1>(value.second) != "axon" or it == map_geom_.end())
+        {
+            continue;
+        }
 
-                        valid_syn = presyn_id != postsyn_id or autapse_allowed;
+        neighbors.clear();
+        step_tree.query(bgi::intersects(value.first) and
+                            bgi::satisfies([](const RtreeValue &v) {
+                                return std::get<1>(v.second) != "axon";
+                            }),
+                        std::back_inserter(neighbors));
 
-                        if (check_syn and valid_syn)
-                        {
-                            // these two are eligible for synapse creation,
-                            // test for the existence of a synapse
-                            BPolygonPtr axon_segment  = map_geom_[axon_info];
-                            BPolygonPtr other_segment = map_geom_[other_info];
+        for (const auto &other : neighbors)
+        {
+            auto it_other = map_geom_.find(other.second);
 
-                            if (bg::intersects(*(axon_segment.get()),
-                                               *(other_segment.get())))
-                            {
-                                bg::intersection(*(axon_segment.get()),
-                                                 *(other_segment.get()),
-                                                 intersection);
+            if (it_other != map_geom_.end())
+            {
+                add_overlap_contact(value.second, *get_polygon(it->second),
+                                    other.second,
+                                    *get_polygon(it_other->second),
+                                    step_contacts);
+            }
+        }
+    }
 
-                                area = bg::area(intersection);
+    append_to_contact_log(step_contacts);
+}
 
-                                tmp          = area * synapse_density;
-                                num_synapses = tmp;
 
-                                if (tmp - num_synapses > uniform_(*(rng.get())))
-                                {
-                                    num_synapses += 1;
-                                }
+/**
+ * @brief Add the contacts of the step to the log.
+ *
+ * Contacts with segments which were removed during the step, or which are
+ * already logged (same pair of segment keys), are skipped.
+ */
+void SpaceManager::append_to_contact_log(const ContactBuffer &contacts)
+{
+    for (stype i = 0; i < contacts.size(); i++)
+    {
+        ObjectInfo pre(contacts.presyn(i)), post(contacts.postsyn(i));
 
-                                for (stype s = 0; s < num_synapses; s++)
-                                {
-                                    // @todo get a random point in the
-                                    // intersection
-                                    bg::centroid(intersection, centroid);
-
-                                    pre_syn_x.push_back(centroid.x());
-                                    pre_syn_y.push_back(centroid.y());
-
-                                    presyn_neurons.push_back(presyn_id);
-                                    postsyn_neurons.push_back(postsyn_id);
-
-                                    presyn_neurites.push_back(
-                                        std::get<1>(axon_info));
-                                    presyn_nodes.push_back(
-                                        std::get<2>(axon_info));
-                                    presyn_segments.push_back(
-                                        std::get<3>(axon_info));
-
-                                    postsyn_neurites.push_back(
-                                        std::get<1>(other_info));
-                                    postsyn_nodes.push_back(
-                                        std::get<2>(other_info));
-                                    postsyn_segments.push_back(
-                                        std::get<3>(other_info));
-                                }
-                            }
-                        }
-                    }
-                }
-            }
+        if (map_geom_.find(pre) == map_geom_.end() or
+            map_geom_.find(post) == map_geom_.end() or
+            not contact_keys_.insert(std::make_pair(pre, post)).second)
+        {
+            continue;
         }
-    }
 
-    // move the new potential sites to the old container and clear it
+        contact_log_.add_contact(
+            pre, post, contacts.contact_area[i],
+            BPoint(contacts.contact_x[i], contacts.contact_y[i]));
 
-    old_potential_synapse_crossing_.insert(
-        old_potential_synapse_crossing_.end(),
-        new_potential_synapse_crossing_.begin(),
-        new_potential_synapse_crossing_.end());
+        contact_objects_[pre]++;
+        contact_objects_[post]++;
+    }
 
-    new_potential_synapse_crossing_.clear();
+    contact_log_time_.resize(contact_log_.size(),
+                             kernel().simulation_manager.get_current_minutes());
 }
 
 
-void SpaceManager::generate_synapses_all(
-    double spine_density, bool only_new_syn, bool autapse_allowed,
-    const std::set<stype> &presyn_pop, const std::set<stype> &postsyn_pop,
-    std::vector<stype> &presyn_neurons, std::vector<stype> &postsyn_neurons,
+/**
+ * @brief Read the contacts recorded while `track_contacts` was on.
+ *
+ * If `only_new` is true, only the contacts logged since the previous call
+ * are returned, so reading the network costs O(new contacts).
+ * Node and segment ids are those of the current morphology and the time is
+ * given in minutes.
+ */
+void SpaceManager::get_contact_log(
+    bool only_new, std::vector<stype> &presyn_neurons,
+    std::vector<stype> &postsyn_neurons,
     std::vector<std::string> &presyn_neurites,
     std::vector<std::string> &postsyn_neurites,
     std::vector<stype> &presyn_nodes, std::vector<stype> &postsyn_nodes,
     std::vector<stype> &presyn_segments, std::vector<stype> &postsyn_segments,
-    std::vector<double> &pre_syn_x, std::vector<double> &pre_syn_y,
-    std::vector<double> &post_syn_x, std::vector<double> &post_syn_y)
+    std::vector<double> &contact_area, std::vector<double> &contact_x,
+    std::vector<double> &contact_y, std::vector<double> &contact_time)
 {
-    // range of points to test
-    std::vector<BPoint> &old_vec_cross = old_potential_synapse_crossing_;
-    std::vector<BPoint> &old_vec_near  = old_potential_synapse_near_;
+    stype start = only_new ? contact_log_read_ : 0;
+
+    ContactBuffer contacts;
+    append_contacts(contact_log_, start, contacts);
+
+    presyn_neurons.swap(contacts.presyn_neurons);
+    postsyn_neurons.swap(contacts.postsyn_neurons);
+    presyn_neurites.swap(contacts.presyn_neurites);
+    postsyn_neurites.swap(contacts.postsyn_neurites);
+    presyn_nodes.swap(contacts.presyn_nodes);
+    postsyn_nodes.swap(contacts.postsyn_nodes);
+    presyn_segments.swap(contacts.presyn_segments);
+    postsyn_segments.swap(contacts.postsyn_segments);
+    contact_area.swap(contacts.contact_area);
+    contact_x.swap(contacts.contact_x);
+    contact_y.swap(contacts.contact_y);
+
+    contact_time.assign(contact_log_time_.begin() + start,
+                        contact_log_time_.end());
+
+    segment_positions(presyn_neurons, presyn_neurites, presyn_nodes,
+                      presyn_segments, 0);
+    segment_positions(postsyn_neurons, postsyn_neurites, postsyn_nodes,
+                      postsyn_segments, 0);
+
+    contact_log_read_ = contact_log_.size();
+}
 
-    if (only_new_syn)
-    {
-        old_vec_near  = std::vector<BPoint>();
-        old_vec_cross = std::vector<BPoint>();
-    }
 
-    point_range points_cross =
-        boost::range::join(new_potential_synapse_crossing_, old_vec_cross);
+/**
+ * @brief Area and centroid of overlaps made of several contacts.
+ *
+ * Contacts sharing the same label in `overlaps` (from 0 to the number of
+ * overlaps minus one) belong to the same overlap, whose geometry is the
+ * intersection of the union of its presynaptic segments with the union of
+ * its postsynaptic segments, both dilated by half of `max_distance` if it is
+ * not zero. The parts shared by several contacts are thus counted once.
+ * Segments are given by their position, as in the contact tables.
+ */
+void SpaceManager::get_overlaps(
+    double max_distance, const std::vector<stype> &overlaps,
+    const std::vector<stype> &presyn_neurons,
+    const std::vector<stype> &postsyn_neurons,
+    const std::vector<std::string> &presyn_neurites,
+    const std::vector<std::string> &postsyn_neurites,
+    const std::vector<stype> &presyn_nodes,
+    const std::vector<stype> &postsyn_nodes,
+    const std::vector<stype> &presyn_segments,
+    const std::vector<stype> &postsyn_segments,
+    std::vector<double> &overlap_area, std::vector<double> &overlap_x,
+    std::vector<double> &overlap_y) const
+{
+    stype num_contacts = overlaps.size();
+    stype num_overlaps =
+        num_contacts ? *std::max_element(overlaps.begin(), overlaps.end()) + 1
+                     : 0;
 
-    point_range points_near =
-        boost::range::join(new_potential_synapse_near_, old_vec_near);
+    // keys of the segments in the R-tree
+    std::vector<stype> pre_nodes(presyn_nodes), post_nodes(postsyn_nodes);
+    std::vector<stype> pre_segments(presyn_segments),
+        post_segments(postsyn_segments);
 
-    auto all_points = boost::range::join(points_cross, points_near);
+    segment_keys(presyn_neurons, presyn_neurites, pre_nodes, pre_segments);
+    segment_keys(postsyn_neurons, postsyn_neurites, post_nodes,
+                 post_segments);
 
-#pragma omp parallel
-    {
-        int omp_id = kernel().parallelism_manager.get_thread_local_id();
-        mtPtr rng  = kernel().rng_manager.get_rng(omp_id);
+    // contacts of each overlap (counting sort)
+    std::vector<stype> start(num_overlaps + 1, 0), members(num_contacts);
 
-        // store the axons and dendrites in a map
-        std::unordered_map<std::string, std::vector<stype>> ntypes(
-            {{"axon", {}}, {"other", {}}});
+    for (stype label : overlaps)
+    {
+        start[label + 1]++;
+    }
 
-        ObjectInfo segment_info, axon_info, other_info;
-        BMultiPolygon axon_buffer, other_buffer;
-        std::vector<ObjectInfo> neighbors_info;
-        stype presyn_id, postsyn_id;
-        BMultiPolygon intersection;
-        bool check_syn, valid_syn;
-        BPoint centroid, p;
-        int num_synapses;
-        double tmp, area;
+    std::partial_sum(start.begin(), start.end(), start.begin());
 
-        for (stype k = 0; k < all_points.size(); k++)
-        {
-            p = all_points[k];
+    std::vector<stype> fill(start.begin(), start.end() - 1);
 
-            // get the properties of the neighboring geometries
-            neighbors_info.clear();
-            get_objects_in_range(p, max_syn_distance_, neighbors_info);
+    for (stype i = 0; i < num_contacts; i++)
+    {
+        members[fill[overlaps[i]]++] = i;
+    }
 
-            BPolygonPtr axon_poly, other_poly;
-            ntypes.clear();
+    overlap_area.assign(num_overlaps, 0.);
+    overlap_x.assign(num_overlaps, std::nan(""));
+    overlap_y.assign(num_overlaps, std::nan(""));
 
-            for (stype i = 0; i < neighbors_info.size(); i++)
-            {
-                segment_info = neighbors_info[i];
+#pragma omp parallel
+    {
+        std::set<ObjectInfo> pre_set, post_set;
+        BMultiPolygon pre_geom, post_geom, intersection;
+        dilated_segment_map dilated;
+        BPoint centroid;
 
-                if (std::get<1>(segment_info) == "axon")
-                {
-                    ntypes["axon"].push_back(i);
-                }
-                else
-                {
-                    ntypes["other"].push_back(i);
-                }
-            }
+#pragma omp for schedule(dynamic)
+        for (long o = 0; o < static_cast<long>(num_overlaps); o++)
+        {
+            pre_set.clear();
+            post_set.clear();
 
-            if (ntypes["other"].size() > 0 and ntypes["axon"].size() > 0)
+            for (stype k = start[o]; k < start[o + 1]; k++)
             {
-                for (stype i : ntypes["axon"])
-                {
-                    axon_info = neighbors_info[i];
-
-                    for (stype j : ntypes["other"])
-                    {
-                        other_info = neighbors_info[j];
-
-                        presyn_id  = std::get<0>(axon_info);
-                        postsyn_id = std::get<0>(other_info);
-
-                        check_syn =
-                            (presyn_pop.find(presyn_id) != presyn_pop.end()) and
-                            (postsyn_pop.find(presyn_id) != postsyn_pop.end());
-
-                        valid_syn = presyn_id != postsyn_id or autapse_allowed;
+                stype i = members[k];
+
+                pre_set.insert(std::make_tuple(presyn_neurons[i],
+                                               presyn_neurites[i],
+                                               pre_nodes[i], pre_segments[i]));
+                post_set.insert(std::make_tuple(
+                    postsyn_neurons[i], postsyn_neurites[i], post_nodes[i],
+                    post_segments[i]));
+            }
 
-                        if (check_syn and valid_syn)
-                        {
-                            // these two are eligible for synapse creation, test
-                            // for the existence of a synapse
-                            BPolygonPtr axon_segment  = map_geom_[axon_info];
-                            BPolygonPtr other_segment = map_geom_[other_info];
-
-                            // make the circle with a buffer
-                            bg::strategy::buffer::distance_symmetric<double>
-                                distance_strategy(0.5 * max_syn_distance_);
-
-                            bg::buffer(*(axon_segment.get()), axon_buffer,
-                                       distance_strategy, side_strategy_,
-                                       join_strategy_, end_strategy_,
-                                       circle_strategy_);
-
-                            bg::buffer(*(other_segment.get()), other_buffer,
-                                       distance_strategy, side_strategy_,
-                                       join_strategy_, end_strategy_,
-                                       circle_strategy_);
-
-                            if (bg::intersects(axon_buffer[0], other_buffer[0]))
-                            {
-                                bg::intersection(axon_buffer[0],
-                                                 other_buffer[0], intersection);
+            segment_union(pre_set, 0.5 * max_distance, dilated, pre_geom);
+            segment_union(post_set, 0.5 * max_distance, dilated, post_geom);
 
-                                area = bg::area(intersection);
+            intersection.clear();
+            bg::intersection(pre_geom, post_geom, intersection);
 
-                                tmp          = area * spine_density;
-                                num_synapses = tmp;
+            overlap_area[o] = bg::area(intersection);
 
-                                if (tmp - num_synapses > uniform_(*(rng.get())))
-                                {
-                                    num_synapses += 1;
-                                }
+            if (overlap_area[o] > 0)
+            {
+                bg::centroid(intersection, centroid);
 
-                                for (stype s = 0; s < num_synapses; s++)
-                                {
-                                    // @todo get a random point in along the
-                                    // segments
-                                    bg::centroid(*(axon_segment.get()),
-                                                 centroid);
-                                    pre_syn_x.push_back(centroid.x());
-                                    pre_syn_y.push_back(centroid.y());
-
-                                    bg::centroid(*(other_segment.get()),
-                                                 centroid);
-                                    post_syn_x.push_back(centroid.x());
-                                    post_syn_y.push_back(centroid.y());
-
-                                    presyn_neurons.push_back(presyn_id);
-                                    postsyn_neurons.push_back(postsyn_id);
-
-                                    presyn_neurites.push_back(
-                                        std::get<1>(axon_info));
-                                    presyn_nodes.push_back(
-                                        std::get<2>(axon_info));
-                                    presyn_segments.push_back(
-                                        std::get<3>(axon_info));
-
-                                    postsyn_neurites.push_back(
-                                        std::get<1>(axon_info));
-                                    postsyn_nodes.push_back(
-                                        std::get<2>(axon_info));
-                                    postsyn_segments.push_back(
-                                        std::get<3>(axon_info));
-                                }
-                            }
-                        }
-                    }
-                }
+                overlap_x[o] = centroid.x();
+                overlap_y[o] = centroid.y();
             }
         }
     }
-
-    // move the new potential sites to the old container and clear it
-
-    old_potential_synapse_crossing_.insert(
-        old_potential_synapse_crossing_.end(),
-        new_potential_synapse_crossing_.begin(),
-        new_potential_synapse_crossing_.end());
-
-    new_potential_synapse_crossing_.clear();
-
-    old_potential_synapse_near_.insert(old_potential_synapse_near_.end(),
-                                       new_potential_synapse_near_.begin(),
-                                       new_potential_synapse_near_.end());
-
-    new_potential_synapse_near_.clear();
 }
 
 
+/**
+ * @brief Whether `point` is inside the environment.
+ *
+ * The test is made on the distance field, which only computes the exact
+ * geometric test close to the walls.
+ */
 bool SpaceManager::env_contains(const BPoint &point) const
 {
     if (not environment_initialized_)
@@ -1571,7 +2809,7 @@ bool SpaceManager::env_contains(const BPoint &point) const
         return 1;
     }
 
-    return bg::within(point, *(environment_manager_->get_environment().get()));
+    return distance_field_->contains(point);
 }
 
 
@@ -1586,9 +2824,11 @@ bool SpaceManager::is_inside(const BPoint &point, stype neuron,
     {
         if (std::get<0>(n) == neuron and std::get<1>(n) == neurite)
         {
-            if (bg::covered_by(point, *(map_geom_.at(n).get())))
+            BPolygonPtr poly = get_polygon(map_geom_.at(n));
+
+            if (bg::covered_by(point, *(poly.get())))
             {
-                polygon = *(map_geom_.at(n).get());
+                polygon = *(poly.get());
                 return true;
             }
         }
@@ -1598,20 +2838,21 @@ bool SpaceManager::is_inside(const BPoint &point, stype neuron,
 }
 
 
+/**
+ * @brief Distance to the nearest wall or area border
+ *
+ * Returns infinity if there is no environment.
+ * The value is read from the distance field: it is exact close to the walls
+ * and a lower bound elsewhere.
+ */
 double SpaceManager::get_wall_distance(const BPoint &position, int omp_id) const
 {
-    //~ GEOSGeometry *boundary;
-    //~ double distance;
-
-    //~ boundary = GEOSBoundary_r(context_handler_,
-    //~ environment_manager_->get_environment());
-
-    //~ GEOSDistance_r(context_handler_, boundary, geospoint.get(), &distance);
-
-    //~ GEOSGeom_destroy_r(context_handler_, boundary);
+    if (not environment_initialized_)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
 
-    //~ return distance;
-    return 0.;
+    return distance_field_->get_distance(position);
 }
 
 
@@ -1674,44 +2915,86 @@ void SpaceManager::get_intersections(const BLineString &line,
 }
 
 
+/**
+ * @brief Add the angles of the intersections between a circle and a segment
+ *
+ * The circle is the polygon of the buffer strategy, given by the unit
+ * `vertices`, so that the angles are those of the buffered circles.
+ */
+void circle_segment_intersections(const BPoint &center, double radius,
+                                  const std::vector<BPoint> &vertices,
+                                  const BPoint &p, const BPoint &q,
+                                  std::vector<double> &angles)
+{
+    double dx(q.x() - p.x()), dy(q.y() - p.y());
+    double fx(p.x() - center.x()), fy(p.y() - center.y());
+
+    // skip the segments which do not reach the circumscribed circle
+    double a = dx * dx + dy * dy;
+    double t_closest(0.);
+
+    if (a > 0)
+    {
+        t_closest = std::max(0., std::min(1., -(fx * dx + fy * dy) / a));
+    }
+
+    if (std::hypot(fx + t_closest * dx, fy + t_closest * dy) > radius)
+    {
+        return;
+    }
+
+    stype num_vertices = vertices.size();
+
+    for (stype i = 0; i < num_vertices; i++)
+    {
+        const BPoint &u = vertices[i];
+        const BPoint &v = vertices[(i + 1) % num_vertices];
+
+        double ax(radius * u.x()), ay(radius * u.y());
+        double ex(radius * (v.x() - u.x())), ey(radius * (v.y() - u.y()));
+
+        double denom = ex * dy - ey * dx;
+
+        if (denom == 0)
+        {
+            continue;
+        }
+
+        // positions along the circle edge (s) and the segment (t)
+        double s = ((fx - ax) * dy - (fy - ay) * dx) / denom;
+        double t = ((fx - ax) * ey - (fy - ay) * ex) / denom;
+
+        if (s >= 0 and s <= 1 and t >= 0 and t <= 1)
+        {
+            angles.push_back(atan2(ay + s * ey, ax + s * ex));
+        }
+    }
+}
+
+
 /**
  * @brief returns the absolute value of the angle widening necessary to unstuck
+ *
+ * The circle of radius `radius` around `position` is intersected with the
+ * nearby walls of the area and with the neighboring segments.
  */
 double SpaceManager::unstuck_angle(const BPoint &position, double current_angle,
                                    double radius, const std::string &area,
                                    int omp_id)
 {
-    // make the circle with a buffer
-    bg::strategy::buffer::distance_symmetric<double> distance_strategy(radius);
-
-    BMultiPolygon tmp;
-    bg::buffer(position, tmp, distance_strategy, side_strategy_, join_strategy_,
-               end_strategy_, circle_strategy_);
-
-    BLineString circle = BLineString();
-    circle.insert(circle.end(), tmp[0].outer().begin(), tmp[0].outer().end());
-
-    BMultiPoint intsct;
+    // angles of the intersection points on the circle
+    std::vector<double> angles;
 
     // get the intersections with area if environment is present
     if (environment_initialized_)
     {
-        BMultiPolygonPtr a = areas_.at(area)->get_area();
+        std::vector<BSegment> walls;
+        areas_.at(area)->get_walls_in_range(position, radius, walls);
 
-        for (auto &p : *(a.get()))
+        for (const auto &wall : walls)
         {
-            if (bg::crosses(circle, p.outer()))
-            {
-                bg::intersection(circle, p.outer(), intsct);
-            }
-
-            for (auto &inner : p.inners())
-            {
-                if (bg::crosses(circle, inner))
-                {
-                    bg::intersection(circle, inner, intsct);
-                }
-            }
+            circle_segment_intersections(position, radius, circle_vertices_,
+                                         wall.first, wall.second, angles);
         }
     }
 
@@ -1721,42 +3004,35 @@ double SpaceManager::unstuck_angle(const BPoint &position, double current_angle,
         std::vector<ObjectInfo> neighbors_info;
         get_objects_in_range(position, radius, neighbors_info);
 
-        for (auto info : neighbors_info)
+        for (const auto &info : neighbors_info)
         {
-            BPolygonPtr other = map_geom_[info];
-            // check for intersections
-            if (other != nullptr and bg::crosses(*(other.get()), circle))
+            auto it = map_geom_.find(info);
+
+            if (it != map_geom_.end() and it->second != nullptr)
             {
-                get_intersections(circle, *(other.get()), intsct);
+                BPolygonPtr poly  = get_polygon(it->second);
+                const BRing &ring = poly->outer();
+
+                for (stype i = 1; i < ring.size(); i++)
+                {
+                    circle_segment_intersections(position, radius,
+                                                 circle_vertices_, ring[i - 1],
+                                                 ring[i], angles);
+                }
             }
         }
     }
 
-    stype num_intersect = intsct.size();
-    double angle_first(0.), angle_last(3.15);
+    double angle_first(0.);
 
-    if (num_intersect)
+    if (not angles.empty())
     {
-        BPoint p = intsct.front();
+        angle_first = std::numeric_limits<double>::infinity();
 
-        angle_first =
-            fmod(std::abs(atan2(p.y() - position.y(), p.x() - position.x()) -
-                          current_angle),
-                 M_PI);
-
-        if (num_intersect > 1)
+        for (double angle : angles)
         {
-            BPoint p2 = intsct.back();
-
-            angle_last = fmod(
-                std::abs(atan2(p2.x() - position.y(), p2.x() - position.x()) -
-                         current_angle),
-                M_PI);
-
-            if (angle_last < angle_first)
-            {
-                angle_first = angle_last;
-            }
+            angle_first = std::min(
+                angle_first, fmod(std::abs(angle - current_angle), M_PI));
         }
     }
 
@@ -1770,6 +3046,12 @@ bool SpaceManager::has_environment() const { return environment_initialized_; }
 bool SpaceManager::interactions_on() const { return interactions_; }
 
 
+/**
+ * @brief Whether new branch points are stored in single precision.
+ */
+bool SpaceManager::compact_geometry() const { return compact_geometry_; }
+
+
 const BRing &SpaceManager::get_env_border(int omp_id) const
 {
     return environment_manager_->get_environment()->at(0).outer();
@@ -1959,10 +3241,31 @@ void SpaceManager::set_environment(
 
     GEOSWKTWriter_destroy_r(context_handler_, writer);
 
+    make_distance_field();
+
     environment_initialized_ = true;
 }
 
 
+/**
+ * @brief Precompute the distance to the walls and area borders
+ */
+void SpaceManager::make_distance_field()
+{
+    BMultiLineString walls = environment_manager_->get_boundary();
+
+    for (const auto &area : areas_)
+    {
+        const BMultiLineString &border = area.second->get_boundary();
+        walls.insert(walls.end(), border.begin(), border.end());
+    }
+
+    distance_field_ = std::unique_ptr<DistanceField>(
+        new DistanceField(environment_manager_->get_environment(), walls,
+                          distance_field_resolution_));
+}
+
+
 void SpaceManager::get_environment(
     GEOSGeom &environment, std::vector<GEOSGeometry *> &areas,
     std::vector<double> &heights, std::vector<std::string> &names,
@@ -2112,8 +3415,7 @@ void SpaceManager::get_area_properties(
 
 void SpaceManager::set_status(const statusMap &config)
 {
-    get_param(config, names::interactions, interactions_);
-
+    // check all values before setting any of them
     double max_syn_dist(max_syn_distance_);
     get_param(config, names::max_synaptic_distance, max_syn_dist);
 
@@ -2123,7 +3425,8 @@ void SpaceManager::set_status(const statusMap &config)
                                     "must be smaller than " +
                                     std::to_string(MAX_MAX_SYN_DIST) + ".");
     }
-    if (kernel().simulation_manager.get_time() != Time())
+    if (max_syn_dist != max_syn_distance_ and
+        kernel().simulation_manager.get_time() != Time())
     {
         throw std::invalid_argument("Cannot change `" +
                                     names::max_synaptic_distance +
@@ -2131,23 +3434,52 @@ void SpaceManager::set_status(const statusMap &config)
                                     "simulation start.");
     }
 
+    double df_resol(distance_field_resolution_);
+    get_param(config, names::distance_field_resolution, df_resol);
+
+    if (df_resol <= 0)
+    {
+        throw std::invalid_argument("`" + names::distance_field_resolution +
+                                    "` must be strictly positive.");
+    }
+
+    get_param(config, names::interactions, interactions_);
+    get_param(config, names::track_contacts, track_contacts_);
+    get_param(config, names::compact_geometry, compact_geometry_);
+
     max_syn_distance_ = max_syn_dist;
+
+    if (df_resol != distance_field_resolution_)
+    {
+        distance_field_resolution_ = df_resol;
+
+        if (environment_initialized_)
+        {
+            make_distance_field();
+        }
+    }
 }
 
 
 void SpaceManager::get_status(statusMap &status) const
 {
+    set_param(status, names::compact_geometry, compact_geometry_, "");
     set_param(status, "environment_initialized", environment_initialized_, "");
+    set_param(status, names::distance_field_resolution,
+              distance_field_resolution_, "micrometer");
     set_param(status, names::interactions, interactions_, "");
     set_param(status, names::max_synaptic_distance, max_syn_distance_,
               "micrometer");
+    set_param(status, names::track_contacts, track_contacts_, "");
 }
 
 
 void SpaceManager::num_threads_changed(int num_omp)
 {
-    geom_add_buffer_ = std::vector<space_tree_map>(num_omp);
+    geom_add_buffer_ = std::vector<geometry_map>(num_omp);
     box_buffer_      = std::vector<std::vector<box_tree_tuple>>(num_omp);
+    new_contacts_    = std::vector<ContactBuffer>(num_omp);
+    new_segments_    = std::vector<std::vector<RtreeValue>>(num_omp);
 }
 
 
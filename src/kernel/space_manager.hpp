@@ -31,6 +31,7 @@
 #include <memory>
 #include <set>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 // libgrowth include
@@ -47,9 +48,49 @@ namespace growth
 {
 
 // forward declare spatial classes
+class DistanceField;
 class Environment;
 
 
+/**
+ * @brief Synapses found by one worker during synapse generation.
+ *
+ * Each thread (or chunk of sites, for deterministic ordering) fills its own
+ * buffer; the buffers are then concatenated into the output tables.
+ */
+struct SynapseBuffer
+{
+    std::vector<stype> presyn_neurons, postsyn_neurons;
+    std::vector<std::string> presyn_neurites, postsyn_neurites;
+    std::vector<stype> presyn_nodes, postsyn_nodes;
+    std::vector<stype> presyn_segments, postsyn_segments;
+    std::vector<double> pre_syn_x, pre_syn_y, post_syn_x, post_syn_y;
+
+    void add_synapse(const ObjectInfo &pre, const ObjectInfo &post,
+                     const BPoint &pre_pos, const BPoint &post_pos);
+    stype size() const;
+};
+
+
+/**
+ * @brief Axon/dendrite (or soma) contacts found by one block of work.
+ */
+struct ContactBuffer
+{
+    std::vector<stype> presyn_neurons, postsyn_neurons;
+    std::vector<std::string> presyn_neurites, postsyn_neurites;
+    std::vector<stype> presyn_nodes, postsyn_nodes;
+    std::vector<stype> presyn_segments, postsyn_segments;
+    std::vector<double> contact_area, contact_x, contact_y;
+
+    void add_contact(const ObjectInfo &pre, const ObjectInfo &post,
+                     double area, const BPoint &position);
+    ObjectInfo presyn(stype i) const;
+    ObjectInfo postsyn(stype i) const;
+    stype size() const;
+};
+
+
 class SpaceManager : public ManagerInterface
 {
   public:
@@ -67,10 +108,11 @@ class SpaceManager : public ManagerInterface
     void add_object(const BPoint &start, const BPoint &stop, double diam,
                     double length, double taper, const ObjectInfo &info,
                     BranchPtr b, int omp_id);
-    void update_objects_branching(TNodePtr old_node, NodePtr new_node,
-                                  stype branching_point, stype neuron,
-                                  const std::string &neurite, int omp_id);
     void remove_object(const BBox &box, const ObjectInfo &info, int omp_id);
+    void remove_neurons(const std::unordered_set<stype> &gids);
+    void remove_neurites(
+        const std::unordered_map<stype, std::unordered_set<std::string>>
+            &neurites);
     void get_objects_in_range(const BPoint &p, double radius,
                               std::vector<ObjectInfo> &v) const;
     void get_intersected_objects(const BPoint &start, const BPoint &stop,
@@ -116,10 +158,16 @@ class SpaceManager : public ManagerInterface
                const std::string &area, double proba_down_move,
                double max_height_up_move, Affinities aff_values, double substep,
                double radius, GCPtr gc_ptr, space_tree_map &neighbors);
+    bool sense_free_space(std::vector<double> &directions_weights,
+                          const Filopodia &filopodia, const BPoint &position,
+                          const Move &move, double radius,
+                          const GeometryPtr last_segment,
+                          double &wall_distance, int omp_id) const;
 
     void check_accessibility(std::vector<double> &directions_weights,
                              const Filopodia &filopodia, const BPoint &position,
-                             const Move &move, const BPolygonPtr last_segment);
+                             const Move &move, const BPolygonPtr last_segment,
+                             double wall_distance = 0.);
 
     void check_synaptic_site(const BPoint &position, double distance,
                              stype neuron_id, const std::string &neurite_name,
@@ -128,16 +176,19 @@ class SpaceManager : public ManagerInterface
                              BPolygonPtr poly);
     void generate_synapses_crossings(
         double synapse_density, bool only_new_syn, bool autapse_allowed,
-        const std::set<stype> &presyn_pop, const std::set<stype> &postsyn_pop,
-        std::vector<stype> &presyn_neurons, std::vector<stype> &postsyn_neurons,
+        bool deterministic, const std::set<stype> &presyn_pop,
+        const std::set<stype> &postsyn_pop, std::vector<stype> &presyn_neurons,
+        std::vector<stype> &postsyn_neurons,
         std::vector<std::string> &presyn_neurites,
         std::vector<std::string> &postsyn_neurites,
         std::vector<stype> &presyn_nodes, std::vector<stype> &postsyn_nodes,
         std::vector<stype> &presyn_segments,
         std::vector<stype> &postsyn_segments, std::vector<double> &pre_syn_x,
-        std::vector<double> &pre_syn_y);
+        std::vector<double> &pre_syn_y, std::vector<double> &post_syn_x,
+        std::vector<double> &post_syn_y);
     void generate_synapses_all(
         double spine_density, bool only_new_syn, bool autapse_allowed,
+        bool deterministic,
         const std::set<stype> &presyn_pop, const std::set<stype> &postsyn_pop,
         std::vector<stype> &presyn_neurons, std::vector<stype> &postsyn_neurons,
         std::vector<std::string> &presyn_neurites,
@@ -147,6 +198,39 @@ class SpaceManager : public ManagerInterface
         std::vector<stype> &postsyn_segments, std::vector<double> &pre_syn_x,
         std::vector<double> &pre_syn_y, std::vector<double> &post_syn_x,
         std::vector<double> &post_syn_y);
+    void get_contacts(
+        double max_distance, bool autapse_allowed,
+        const std::set<stype> &presyn_pop, const std::set<stype> &postsyn_pop,
+        std::vector<stype> &presyn_neurons, std::vector<stype> &postsyn_neurons,
+        std::vector<std::string> &presyn_neurites,
+        std::vector<std::string> &postsyn_neurites,
+        std::vector<stype> &presyn_nodes, std::vector<stype> &postsyn_nodes,
+        std::vector<stype> &presyn_segments,
+        std::vector<stype> &postsyn_segments,
+        std::vector<double> &contact_area, std::vector<double> &contact_x,
+        std::vector<double> &contact_y) const;
+    void get_contact_log(
+        bool only_new, std::vector<stype> &presyn_neurons,
+        std::vector<stype> &postsyn_neurons,
+        std::vector<std::string> &presyn_neurites,
+        std::vector<std::string> &postsyn_neurites,
+        std::vector<stype> &presyn_nodes, std::vector<stype> &postsyn_nodes,
+        std::vector<stype> &presyn_segments,
+        std::vector<stype> &postsyn_segments,
+        std::vector<double> &contact_area, std::vector<double> &contact_x,
+        std::vector<double> &contact_y, std::vector<double> &contact_time);
+    void get_overlaps(
+        double max_distance, const std::vector<stype> &overlaps,
+        const std::vector<stype> &presyn_neurons,
+        const std::vector<stype> &postsyn_neurons,
+        const std::vector<std::string> &presyn_neurites,
+        const std::vector<std::string> &postsyn_neurites,
+        const std::vector<stype> &presyn_nodes,
+        const std::vector<stype> &postsyn_nodes,
+        const std::vector<stype> &presyn_segments,
+        const std::vector<stype> &postsyn_segments,
+        std::vector<double> &overlap_area, std::vector<double> &overlap_x,
+        std::vector<double> &overlap_y) const;
 
     void set_environment(
         GEOSGeom environment, const std::vector<GEOSGeom> &areas,
@@ -162,6 +246,7 @@ class SpaceManager : public ManagerInterface
     void destroy_geom(GEOSGeom geom) const;
     void copy_polygon(BMultiPolygonPtr copy, const BPolygon &p);
     void copy_polygon(BMultiPolygonPtr copy, const BMultiPolygon &p);
+    void make_distance_field();
     BPolygon make_disk(BPoint position, double radius) const;
 
     int get_region_thread(const BPoint &position) const;
@@ -178,32 +263,81 @@ class SpaceManager : public ManagerInterface
 
     bool has_environment() const;
     bool interactions_on() const;
+    bool compact_geometry() const;
 
   private:
+    template <class Predicate> void remove_objects_if(Predicate pred);
+    template <class Predicate> void purge_contact_log(Predicate pred);
+    void segment_positions(const std::vector<stype> &neurons,
+                           const std::vector<std::string> &neurites,
+                           std::vector<stype> &nodes,
+                           std::vector<stype> &segments, stype start) const;
+    void segment_keys(const std::vector<stype> &neurons,
+                      const std::vector<std::string> &neurites,
+                      std::vector<stype> &nodes,
+                      std::vector<stype> &segments) const;
+    void record_contacts(const ObjectInfo &info, const BPolygon &poly,
+                         const BBox &box, int omp_id);
+    void update_contact_log();
+    void append_to_contact_log(const ContactBuffer &contacts);
+    void detect_synapses(const std::vector<BPoint> &points,
+                         bool crossings_only, double density,
+                         bool autapse_allowed, bool deterministic,
+                         const std::set<stype> &presyn_pop,
+                         const std::set<stype> &postsyn_pop,
+                         std::vector<SynapseBuffer> &buffers) const;
+    void synapses_at_site(const BPoint &p, bool crossings_only,
+                          double density, bool autapse_allowed,
+                          const std::set<stype> &presyn_pop,
+                          const std::set<stype> &postsyn_pop,
+                          std::mt19937 &rng, dilated_segment_map &dilated,
+                          SynapseBuffer &buffer) const;
+    const BPolygon &get_dilated_segment(const ObjectInfo &info,
+                                        double distance,
+                                        dilated_segment_map &cache) const;
+    void segment_union(const std::set<ObjectInfo> &segments, double distance,
+                       dilated_segment_map &cache, BMultiPolygon &geom) const;
+
     // buffer strategies
     int points_per_circle_;
     bg::strategy::buffer::join_round join_strategy_;
     boost::geometry::strategy::buffer::end_flat end_strategy_;
     bg::strategy::buffer::point_circle circle_strategy_;
+    std::vector<BPoint> circle_vertices_; // unit vertices of buffered circles
     bg::strategy::buffer::side_straight side_strategy_;
     bool initialized_;
     bool environment_initialized_;
     bool interactions_; // whether neurites interact together
+    bool compact_geometry_; // float32 storage of the points and segments
     GEOSContextHandle_t context_handler_;
     std::unique_ptr<Environment> environment_manager_;
+    std::unique_ptr<DistanceField> distance_field_;
+    double distance_field_resolution_;
     std::unordered_map<std::string, AreaPtr> areas_;
     bgi::rtree<RtreeValue, bgi::quadratic<16>> rtree_;
-    space_tree_map map_geom_;
-    std::vector<space_tree_map> geom_add_buffer_;
+    geometry_map map_geom_;
+    std::vector<geometry_map> geom_add_buffer_;
     std::vector<std::vector<box_tree_tuple>> box_buffer_;
     // potential synaptic sites
     double max_syn_distance_;
     BMultiPolygon known_synaptic_sites_;
-    std::uniform_real_distribution<double> uniform_;
     std::vector<BPoint> old_potential_synapse_crossing_;
     std::vector<BPoint> new_potential_synapse_crossing_;
     std::vector<BPoint> old_potential_synapse_near_;
     std::vector<BPoint> new_potential_synapse_near_;
+    // incremental contact detection
+    bool track_contacts_;
+    std::vector<ContactBuffer> new_contacts_;
+    std::vector<std::vector<RtreeValue>> new_segments_;
+    ContactBuffer contact_log_;
+    std::vector<double> contact_log_time_;
+    stype contact_log_read_;
+    // logged (pre, post) pairs and number of logged contacts of each object
+    std::unordered_set<std::pair<ObjectInfo, ObjectInfo>,
+                       boost::hash<std::pair<ObjectInfo, ObjectInfo>>>
+        contact_keys_;
+    std::unordered_map<ObjectInfo, stype, boost::hash<ObjectInfo>>
+        contact_objects_;
 };
 
 
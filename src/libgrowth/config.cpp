@@ -21,6 +21,9 @@
 
 #include "config.hpp"
 
+#include <algorithm>
+#include <stdexcept>
+
 
 namespace growth
 {
@@ -255,4 +258,191 @@ Property::~Property()
         break;
     }
 }
+
+
+// StatusTable
+
+StatusTable::StatusTable()
+    : num_objects_(0)
+{
+}
+
+
+StatusTable::StatusTable(stype num_objects)
+    : num_objects_(num_objects)
+{
+}
+
+
+stype StatusTable::size() const { return num_objects_; }
+
+
+const statusMap &StatusTable::get_common() const { return common_; }
+
+
+void StatusTable::set_common(const statusMap &common) { common_ = common; }
+
+
+/**
+ * @brief Set the values of a varying parameter (one per object).
+ */
+void StatusTable::set_column(const std::string &key,
+                             const std::vector<Property> &values)
+{
+    check_size(key, values.size());
+    remove_key(key);
+
+    keys_.push_back(key);
+    columns_.push_back(values);
+}
+
+
+/**
+ * @brief Set the values of a varying floating point parameter.
+ */
+void StatusTable::set_double_column(const std::string &key,
+                                    const std::vector<double> &values)
+{
+    check_size(key, values.size());
+    remove_key(key);
+
+    double_keys_.push_back(key);
+    double_columns_.push_back(values);
+}
+
+
+/**
+ * @brief Overwrite the parameters with those of `other`, which must describe
+ * the same objects.
+ */
+void StatusTable::update(const StatusTable &other)
+{
+    if (other.num_objects_ != num_objects_)
+    {
+        throw std::invalid_argument(
+            "Cannot update a StatusTable with one of a different size.");
+    }
+
+    for (const auto &entry : other.common_)
+    {
+        remove_key(entry.first);
+        common_[entry.first] = entry.second;
+    }
+
+    for (stype k = 0; k < other.keys_.size(); k++)
+    {
+        set_column(other.keys_[k], other.columns_[k]);
+    }
+
+    for (stype k = 0; k < other.double_keys_.size(); k++)
+    {
+        set_double_column(other.double_keys_[k], other.double_columns_[k]);
+    }
+}
+
+
+/**
+ * @brief Initialize `status` with the common values and get the entries
+ * that `fill` will update for each object.
+ *
+ * Pointers to the elements of an unordered_map stay valid when new elements
+ * are inserted, but `status` must not be modified otherwise between calls to
+ * `fill`.
+ */
+void StatusTable::prepare(statusMap &status,
+                          std::vector<Property *> &slots) const
+{
+    status = common_;
+    slots.clear();
+
+    for (const auto &key : keys_)
+    {
+        slots.push_back(&status[key]);
+    }
+
+    // double entries are created once, then only their value is changed
+    for (const auto &key : double_keys_)
+    {
+        Property &prop = status[key];
+        prop           = Property(0., "");
+        slots.push_back(&prop);
+    }
+}
+
+
+/**
+ * @brief Set the varying values of object `i` in the prepared status.
+ */
+void StatusTable::fill(stype i, const std::vector<Property *> &slots) const
+{
+    stype num_columns = columns_.size();
+
+    for (stype k = 0; k < num_columns; k++)
+    {
+        *(slots[k]) = columns_[k][i];
+    }
+
+    for (stype k = 0; k < double_columns_.size(); k++)
+    {
+        slots[num_columns + k]->d = double_columns_[k][i];
+    }
+}
+
+
+/**
+ * @brief Full status of object `i`.
+ */
+statusMap StatusTable::get_status(stype i) const
+{
+    statusMap status(common_);
+
+    for (stype k = 0; k < keys_.size(); k++)
+    {
+        status[keys_[k]] = columns_[k][i];
+    }
+
+    for (stype k = 0; k < double_keys_.size(); k++)
+    {
+        status[double_keys_[k]] = Property(double_columns_[k][i], "");
+    }
+
+    return status;
+}
+
+
+void StatusTable::check_size(const std::string &key, stype num_values) const
+{
+    if (num_values != num_objects_)
+    {
+        throw std::invalid_argument(
+            "`" + key + "` must contain " + std::to_string(num_objects_) +
+            " values, got " + std::to_string(num_values) + ".");
+    }
+}
+
+
+/**
+ * @brief Remove `key` from the common values and from the columns.
+ */
+void StatusTable::remove_key(const std::string &key)
+{
+    common_.erase(key);
+
+    auto it = std::find(keys_.begin(), keys_.end(), key);
+
+    if (it != keys_.end())
+    {
+        columns_.erase(columns_.begin() + (it - keys_.begin()));
+        keys_.erase(it);
+    }
+
+    it = std::find(double_keys_.begin(), double_keys_.end(), key);
+
+    if (it != double_keys_.end())
+    {
+        double_columns_.erase(double_columns_.begin() +
+                              (it - double_keys_.begin()));
+        double_keys_.erase(it);
+    }
+}
 } // namespace growth
@@ -0,0 +1,184 @@
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <unordered_map>
+#include <vector>
+
+#include "growth_names.hpp"
+
+
+namespace growth
+{
+
+// Define whether MPI is available
+/* #undef WITH_MPI */
+// Define whether OpenMP is available
+#define WITH_OMP
+/* #undef MSVC */
+
+#ifdef MSVC
+typedef unsigned long stype;
+#else
+typedef size_t stype;
+#endif
+
+typedef enum
+{
+    BOOL,
+    DOUBLE,
+    INT,
+    SIZE,
+    VEC_SIZE,
+    VEC_LONG,
+    STRING,
+    SET_STRING,
+    VEC_STRING,
+    MAP_DOUBLE
+} dtype;
+
+
+class Property
+{
+  public:
+    Property();
+    Property(int i_, const std::string &dim);
+    Property(stype ul_, const std::string &dim);
+    Property(bool b_, const std::string &dim);
+    Property(char const arr[], const std::string &dim);
+    Property(double d_, const std::string &dim);
+    Property(const std::vector<long> &v, const std::string &dim);
+    Property(const std::vector<stype> &v, const std::string &dim);
+    Property(std::string s_, const std::string &dim);
+    Property(const std::unordered_set<std::string> &s, const std::string &dim);
+    Property(const std::vector<std::string> &v, const std::string &dim);
+    Property(const std::unordered_map<std::string, double> &v,
+             const std::string &dim);
+
+    Property(const Property &prop);
+
+    Property &operator=(const Property &prop);
+
+    ~Property();
+
+    dtype data_type;
+    std::string dimension;
+
+    union {
+        bool b;
+        double d;
+        int i;
+        stype ul;
+        std::vector<long> ll;
+        std::vector<stype> uu;
+        std::string s;
+        std::vector<std::string> vs;
+        std::unordered_set<std::string> ss;
+        std::unordered_map<std::string, double> md;
+    };
+};
+
+typedef std::unordered_map<std::string, Property> statusMap;
+
+
+/**
+ * @brief Parameters of a group of objects (e.g. neurons created together).
+ *
+ * Values shared by all objects are stored once in a common statusMap, while
+ * the parameters that vary are stored as columns containing one Property per
+ * object.
+ * Floating point parameters (positions, soma radii...) can also be given as
+ * plain columns of doubles, which are cheap to build from NumPy arrays.
+ * To read the objects one after the other, a status is prepared once with
+ * `prepare`, then `fill` only overwrites the varying entries in place,
+ * through pointers obtained during preparation, so that reading an object
+ * involves neither a map copy nor a key lookup.
+ */
+class StatusTable
+{
+  public:
+    StatusTable();
+    StatusTable(stype num_objects);
+
+    stype size() const;
+    const statusMap &get_common() const;
+    void set_common(const statusMap &common);
+    void set_column(const std::string &key,
+                    const std::vector<Property> &values);
+    void set_double_column(const std::string &key,
+                           const std::vector<double> &values);
+    void update(const StatusTable &other);
+
+    void prepare(statusMap &status, std::vector<Property *> &slots) const;
+    void fill(stype i, const std::vector<Property *> &slots) const;
+    statusMap get_status(stype i) const;
+
+  private:
+    void check_size(const std::string &key, stype num_values) const;
+    void remove_key(const std::string &key);
+
+    stype num_objects_;
+    statusMap common_;
+    std::vector<std::string> keys_;
+    std::vector<std::vector<Property>> columns_;
+    std::vector<std::string> double_keys_;
+    std::vector<std::vector<double>> double_columns_;
+};
+
+// getting/setting parameters from a statusMap/statusMap
+
+inline bool get_param(const statusMap &map, const std::string &key,
+                      bool &result);
+inline bool get_param(const statusMap &map, const std::string &key,
+                      double &result);
+inline bool get_param(const statusMap &map, const std::string &key,
+                      int &result);
+inline bool get_param(const statusMap &map, const std::string &key,
+                      stype &result);
+inline bool get_param(const statusMap &map, const std::string &key,
+                      std::vector<stype> &result);
+inline bool get_param(const statusMap &map, const std::string &key,
+                      std::vector<long> &result);
+inline bool get_param(const statusMap &map, const std::string &key,
+                      char *&result);
+inline bool get_param(const statusMap &map, const std::string &key,
+                      std::string &result);
+inline bool get_param(const statusMap &map, const std::string &key,
+                      std::vector<std::string> &result);
+inline bool get_param(const statusMap &map, const std::string &key,
+                      std::unordered_set<std::string> &result);
+inline bool get_param(const statusMap &map, const std::string &key,
+                      std::unordered_map<std::string, double> &result);
+
+inline void set_param(statusMap &map, const std::string &key, const bool &value,
+                      const std::string &dim);
+inline void set_param(statusMap &map, const std::string &key,
+                      const double &value, const std::string &dim);
+inline void set_param(statusMap &map, const std::string &key, const int &value,
+                      const std::string &dim);
+inline void set_param(statusMap &map, const std::string &key,
+                      const stype &value, const std::string &dim);
+inline void set_param(statusMap &map, const std::string &key,
+                      const std::vector<stype> &value, const std::string &dim);
+inline void set_param(statusMap &map, const std::string &key,
+                      const std::vector<long> &value, const std::string &dim);
+inline void set_param(statusMap &map, const std::string &key,
+                      const std::string &value, const std::string &dim);
+inline void set_param(statusMap &map, const std::string &key,
+                      const std::vector<std::string> &value,
+                      const std::string &dim);
+inline void set_param(statusMap &map, const std::string &key,
+                      const std::unordered_set<std::string> &value,
+                      const std::string &dim);
+inline void set_param(statusMap &map, const std::string &key,
+                      const std::unordered_map<std::string, double> &value,
+                      const std::string &dim);
+} // namespace growth
+
+
+#include "config_impl.hpp"
+
+#endif // CONFIG_H
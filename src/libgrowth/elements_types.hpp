@@ -59,8 +59,8 @@ typedef std::vector<std::vector<double>> Random_vecs;
 typedef std::unordered_map<std::string, double> Param;
 
 
-// Event type, contains (event_time, neuron, neurite, gc, event_type)
-typedef std::tuple<Time, stype, std::string, int, signed char> Event;
+// Event type, contains (event_time, neuron, neurite id, gc, event_type)
+typedef std::tuple<Time, stype, stype, int, signed char> Event;
 
 namespace edata
 {
@@ -56,12 +56,14 @@ const std::string
     affinity_dendrite_soma_other_neuron("affinity_dendrite_soma_other_neuron");
 const std::string
     affinity_dendrite_soma_same_neuron("affinity_dendrite_soma_same_neuron");
+const std::string asynchronous_events("asynchronous_events");
 const std::string axon_angle("axon_angle");
 const std::string axon_polarization_weight("axon_polarization_weight");
 
 const std::string B("B");
 const std::string branching_proba_default("branching_proba_default");
 
+const std::string compact_geometry("compact_geometry");
 const std::string critical_pull("critical_pull");
 
 const std::string memory_decay_factor("memory_decay_factor");
@@ -71,6 +73,7 @@ const std::string diameter_eta_exp("diameter_eta_exp");
 const std::string diameter_fraction_lb("diameter_fraction_lb");
 const std::string diameter_ratio_avg("diameter_ratio_avg");
 const std::string diameter_ratio_std("diameter_ratio_std");
+const std::string distance_field_resolution("distance_field_resolution");
 const std::string duration_retraction("duration_of_retraction");
 
 const std::string E("E");
@@ -85,6 +88,7 @@ const std::string gamma_coeff("gamma_coeff");
 const std::string gc_split_angle_mean("gc_split_angle_mean");
 const std::string gc_split_angle_std("gc_split_angle_std");
 const std::string growth_cone_model("growth_cone_model");
+const std::string growth_cone_tasks("growth_cone_tasks");
 
 const std::string has_axon("has_axon");
 
@@ -94,6 +98,8 @@ const std::string interactions("interactions");
 
 const std::string lateral_branching_angle_mean("lateral_branching_angle_mean");
 const std::string lateral_branching_angle_std("lateral_branching_angle_std");
+const std::string load_balancing("load_balancing");
+const std::string load_balancing_interval("load_balancing_interval");
 
 const std::string max_allowed_resolution("max_allowed_resolution");
 const std::string max_arbor_length("max_arbor_length");
@@ -114,6 +120,8 @@ const std::string points_per_circle("points_per_circle");
 const std::string polarization_strength("polarization_strength");
 const std::string proba_down_move("proba_down_move");
 const std::string proba_retraction("retraction_probability");
+const std::string profile("profile");
+const std::string profiling("profiling");
 
 const std::string random_rotation_angles("random_rotation_angles");
 const std::string res_branching_proba("res_branching_proba");
@@ -163,6 +171,7 @@ const std::string substrate_affinity("substrate_affinity");
 
 const std::string T("T");
 const std::string taper_rate("taper_rate");
+const std::string track_contacts("track_contacts");
 
 const std::string uniform_branching_rate("uniform_branching_rate");
 const std::string uniform_split_rate("uniform_split_rate");
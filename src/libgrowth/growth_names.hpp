@@ -312,12 +312,23 @@ extern const std::string num_growth_cones;
  * Kernel and space
  */
 
+extern const std::string asynchronous_events;
+extern const std::string compact_geometry;
+extern const std::string distance_field_resolution;
+extern const std::string growth_cone_tasks;
 extern const std::string interactions;
+extern const std::string load_balancing;
+extern const std::string load_balancing_interval;
 extern const std::string max_allowed_resolution;
 extern const std::string max_synaptic_distance;
+extern const std::string profile;
+extern const std::string profiling;
 extern const std::string resolution;
+extern const std::string track_contacts;
 
 #define DEFAULT_MAX_RESOL 30.
+#define DEFAULT_BALANCING_INTERVAL 50 // steps
+#define DISTANCE_FIELD_RESOLUTION 5. // micrometers
 #define MAX_MAX_SYN_DIST 5.
 
 
@@ -23,15 +23,21 @@
 
 #include <cmath>
 #include <cstdlib>
-#include <stdio.h>
 
 #include "exceptions.hpp"
 
+// ticks in larger units
+#define TICKS_PER_SECOND (Time::TICKS_PER_MINUTE / 60)
+#define TICKS_PER_HOUR (Time::TICKS_PER_MINUTE * 60)
+#define TICKS_PER_DAY (Time::TICKS_PER_MINUTE * 1440)
+
+
 namespace growth
 {
 
 const double Time::DEFAULT_RESOLUTION(1.);   // in minutes
 double Time::RESOLUTION(DEFAULT_RESOLUTION); // in minutes
+const Time::timeTick Time::TICKS_PER_MINUTE;
 
 void Time::reset_resolution() { RESOLUTION = DEFAULT_RESOLUTION; }
 
@@ -48,153 +54,177 @@ Time Time::from_steps(stype step, double substep)
 }
 
 
+/**
+ * @brief Convert a duration in minutes to the closest number of ticks.
+ */
+Time::timeTick Time::minutes_to_ticks(double minutes)
+{
+    return std::llround(minutes * TICKS_PER_MINUTE);
+}
+
+
+/**
+ * @brief Duration of `steps` full steps, rounded once from the total count.
+ */
+Time::timeTick Time::steps_to_ticks(Time::timeStep steps)
+{
+    return std::llround(steps * RESOLUTION * TICKS_PER_MINUTE);
+}
+
+
+double Time::ticks_to_minutes(Time::timeTick ticks)
+{
+    return ticks / static_cast<double>(TICKS_PER_MINUTE);
+}
+
+
 // Time
 
 Time::Time()
-    : sec_(0.)
-    , min_(0)
-    , hour_(0)
-    , day_(0)
+    : ticks_(0)
 {
 }
 
 
 Time::Time(double seconds, unsigned char minutes, unsigned char hours,
            stype days)
-    : sec_(0.)
-    , min_(0)
-    , hour_(0)
-    , day_(0)
+    : ticks_(0)
 {
-    set_day(days);
-    set_hour(hours);
-    set_min(minutes);
-    set_sec(seconds);
+    ticks_ = days * TICKS_PER_DAY + hours * TICKS_PER_HOUR +
+             minutes * TICKS_PER_MINUTE +
+             std::llround(seconds * TICKS_PER_SECOND);
 }
 
 
 Time::Time(const Time &initial_time, Time::timeStep steps = 0L)
-    : sec_(initial_time.get_sec())
-    , min_(initial_time.get_min())
-    , hour_(initial_time.get_hour())
-    , day_(initial_time.get_day())
+    : ticks_(initial_time.ticks_)
 {
     update(steps, 0.);
 }
 
 
+/**
+ * @brief Advance the time by `steps` full steps plus `substeps` minutes.
+ *
+ * `steps` must be the absolute step count from the origin of the time
+ * (e.g. the initial time of the simulation): the step boundaries are then
+ * rounded once from that count and are the same as the ones used by
+ * `to_steps`. Chaining calls with relative counts would accumulate one
+ * rounding error per call when RESOLUTION is not a whole number of ticks.
+ */
 void Time::update(Time::timeStep steps, double substeps)
 {
-    if (steps != 0L or substeps != 0.)
-    {
-        // prepare the quotient and remainder struct for integer division
-        std::ldiv_t dv{};
-
-        // total minutes in the step duration
-        double total_min       = steps * RESOLUTION + substeps;
-        Time::timeStep int_min = std::floor(total_min);
-        double frac_min        = total_min - int_min;
-        double frac_sec        = frac_min * 60. - (int)(frac_min * 60.);
-
-        // seconds
-        dv   = std::div(sec_ + frac_min * 60., 60L);
-        sec_ = (float)(dv.rem + frac_sec);
-        // minutes
-        dv   = std::div(min_ + int_min + dv.quot, 60L);
-        min_ = (char)dv.rem;
-        // hours
-        dv    = std::div(hour_ + dv.quot, 24L);
-        hour_ = (char)dv.rem;
-        // day
-        day_ += (stype)dv.quot;
-    }
+    ticks_ += steps_to_ticks(steps) + minutes_to_ticks(substeps);
 }
 
 // getters
 
 double Time::get_total_seconds() const
 {
-    return sec_ + min_ * 60 + hour_ * 3600 + day_ * 86400;
+    return ticks_ / static_cast<double>(TICKS_PER_SECOND);
 }
 
 
-double Time::get_total_minutes() const
-{
-    return sec_ / 60. + min_ + hour_ * 60 + day_ * 1440;
-}
+double Time::get_total_minutes() const { return ticks_to_minutes(ticks_); }
 
 
 double Time::get_total_hours() const
 {
-    return sec_ / 3600. + min_ / 60. + hour_ + day_ * 24;
+    return ticks_ / static_cast<double>(TICKS_PER_HOUR);
 }
 
 
 double Time::get_total_days() const
 {
-    return sec_ / 86400. + min_ / 1440. + hour_ / 24. + day_;
+    return ticks_ / static_cast<double>(TICKS_PER_DAY);
 }
 
 
-double Time::get_sec() const { return sec_; }
+double Time::get_sec() const
+{
+    return (ticks_ % TICKS_PER_MINUTE) / static_cast<double>(TICKS_PER_SECOND);
+}
 
 
-unsigned char Time::get_min() const { return min_; }
+unsigned char Time::get_min() const
+{
+    return (ticks_ % TICKS_PER_HOUR) / TICKS_PER_MINUTE;
+}
 
 
-unsigned char Time::get_hour() const { return hour_; }
+unsigned char Time::get_hour() const
+{
+    return (ticks_ % TICKS_PER_DAY) / TICKS_PER_HOUR;
+}
 
 
-stype Time::get_day() const { return day_; }
+stype Time::get_day() const { return ticks_ / TICKS_PER_DAY; }
 
 
 // setters
 
+/**
+ * @brief Replace one component of the time (value given in ticks), values
+ * larger than the component range carry over to the larger units.
+ */
+void Time::set_component(timeTick value, timeTick unit, timeTick modulo)
+{
+    timeTick current = (modulo > 0) ? (ticks_ % modulo) / unit * unit
+                                    : ticks_ / unit * unit;
+
+    ticks_ += value - current;
+}
+
+
 void Time::set_sec(double seconds)
 {
-    sec_ = seconds;
-    if (seconds >= 60.)
-    {
-        int int_part = seconds / 60;
-        sec_ -= int_part * 60.;
-        set_min(min_ + int_part);
-    }
+    set_component(std::llround(seconds * TICKS_PER_SECOND), 1,
+                  TICKS_PER_MINUTE);
 }
 
 
 void Time::set_min(unsigned char minutes)
 {
-    min_ = minutes;
-    if (minutes >= 60)
-    {
-        minutes /= 60;
-        min_ -= minutes * 60;
-        set_hour(hour_ + minutes);
-    }
+    set_component(minutes * TICKS_PER_MINUTE, TICKS_PER_MINUTE,
+                  TICKS_PER_HOUR);
 }
 
 
 void Time::set_hour(unsigned char hours)
 {
-    hour_ = hours;
-    if (hours >= 24)
-    {
-        hours /= 24;
-        hour_ -= hours * 24;
-        set_day(day_ + hours);
-    }
+    set_component(hours * TICKS_PER_HOUR, TICKS_PER_HOUR, TICKS_PER_DAY);
 }
 
 
-void Time::set_day(stype days) { day_ = days; }
+void Time::set_day(stype days)
+{
+    set_component(days * TICKS_PER_DAY, TICKS_PER_DAY, 0);
+}
 
 
 // convert time to steps
 
+/**
+ * @brief Split a duration into full steps and a remaining substep (minutes).
+ *
+ * Inverse of `update`: `steps` is the last step boundary before `t`.
+ */
 void Time::to_steps(const Time &t, timeStep &steps, double &substep)
 {
-    steps   = (timeStep)std::floor(t.get_total_minutes() / RESOLUTION);
-    substep = t.get_total_minutes() - steps * RESOLUTION;
+    steps = static_cast<timeStep>(t.ticks_ / (RESOLUTION * TICKS_PER_MINUTE));
+
+    // correct the floating point division using the rounded boundaries
+    while (steps > 0 and steps_to_ticks(steps) > t.ticks_)
+    {
+        steps--;
+    }
+
+    while (steps_to_ticks(steps + 1) <= t.ticks_)
+    {
+        steps++;
+    }
+
+    substep = ticks_to_minutes(t.ticks_ - steps_to_ticks(steps));
 }
 
 
@@ -202,10 +232,7 @@ void Time::to_steps(const Time &t, timeStep &steps, double &substep)
 
 Time &Time::operator+=(const Time &rhs)
 {
-    this->set_sec(sec_ + rhs.get_sec());
-    this->set_min(min_ + rhs.get_min());
-    this->set_hour(hour_ + rhs.get_hour());
-    this->set_day(day_ + rhs.get_day());
+    ticks_ += rhs.ticks_;
     return *this;
 }
 
@@ -219,51 +246,12 @@ Time operator+(Time lhs, const Time &rhs)
 
 Time &Time::operator-=(const Time &rhs)
 {
-    // define integer and decimal parts
-    stype int_part;
-    double dec_part;
-    long int signed_tmp;
-    int carry_over = 0;
-
-    // subtract and convert
-    sec_ -= rhs.get_sec();
-    if (sec_ < 0)
-    {
-        sec_       = sec_ + 60. - rhs.get_sec();
-        carry_over = 1;
-    }
-
-    signed_tmp = min_ - rhs.get_min() - carry_over; // min
-    if (signed_tmp < 0)
-    {
-        min_       = min_ + 60 - rhs.get_min() - carry_over;
-        carry_over = 1;
-    }
-    else
-    {
-        min_       = signed_tmp;
-        carry_over = 0;
-    }
-
-    signed_tmp = hour_ - rhs.get_hour() - carry_over; // hour
-    if (signed_tmp < 0)
-    {
-        hour_      = 24 + hour_ - rhs.get_hour() - carry_over;
-        carry_over = 1;
-    }
-    else
-    {
-        hour_      = signed_tmp;
-        carry_over = 0;
-    }
-
-    signed_tmp = day_ - rhs.get_day() - carry_over; // day
-    if (signed_tmp < 0)
+    if (rhs.ticks_ > ticks_)
     {
         throw InvalidTime(__FUNCTION__, __FILE__, __LINE__);
     }
 
-    day_ = signed_tmp;
+    ticks_ -= rhs.ticks_;
 
     return *this;
 }
@@ -34,6 +34,16 @@ namespace growth
 class SimulationManager;
 class Neurite;
 
+/**
+ * @brief Simulation time.
+ *
+ * Time is stored internally as an integer number of ticks (fixed resolution
+ * of `TICKS_PER_MINUTE` per minute) so that the scheduling of steps and
+ * events relies on exact integer comparisons and does not drift when many
+ * steps are accumulated.
+ * The day/hour/minute/second representation is only used to communicate
+ * with the user.
+ */
 class Time
 {
 
@@ -43,6 +53,10 @@ class Time
 
   public:
     typedef unsigned long timeStep;
+    typedef long long timeTick;
+
+    //! Number of ticks in one minute (millisecond resolution)
+    static const timeTick TICKS_PER_MINUTE = 60000LL;
 
     Time();
     Time(double seconds, unsigned char minutes, unsigned char hours,
@@ -55,15 +69,18 @@ class Time
     static Time from_steps(stype step, double substep);
     static void to_steps(const Time &t, timeStep &steps, double &substep);
 
+    static timeTick minutes_to_ticks(double minutes);
+    static timeTick steps_to_ticks(timeStep steps);
+    static double ticks_to_minutes(timeTick ticks);
+
   private:
     // class members
     static const double DEFAULT_RESOLUTION;
     static double RESOLUTION;
     // instance members
-    double sec_;
-    unsigned char min_;
-    unsigned char hour_;
-    stype day_;
+    timeTick ticks_;
+
+    void set_component(timeTick value, timeTick unit, timeTick modulo);
 
   public:
     Time &operator+=(const Time &rhs);
@@ -73,16 +90,13 @@ class Time
 
     void update(const unsigned long steps, double substep);
 
+    timeTick get_ticks() const;
+
     double get_sec() const;
     unsigned char get_min() const;
     unsigned char get_hour() const;
     stype get_day() const;
 
-    // void get_sec(double sec) const;
-    // void get_min(double min) const;
-    // void get_hour(double hour) const;
-    // void get_day(double day) const;
-
     double get_total_seconds() const;
     double get_total_minutes() const;
     double get_total_hours() const;
@@ -98,13 +112,11 @@ class Time
  * Implementation of operators
  */
 
+inline Time::timeTick Time::get_ticks() const { return ticks_; }
+
 inline bool operator==(const Time &lhs, const Time &rhs)
 {
-    bool equal = (lhs.get_day() == rhs.get_day());
-    equal &= (lhs.get_hour() == rhs.get_hour());
-    equal &= (lhs.get_min() == rhs.get_min());
-    equal &= (std::abs(lhs.get_sec() - rhs.get_sec()) < 1e-8);
-    return equal;
+    return lhs.get_ticks() == rhs.get_ticks();
 }
 
 inline bool operator!=(const Time &lhs, const Time &rhs)
@@ -114,7 +126,7 @@ inline bool operator!=(const Time &lhs, const Time &rhs)
 
 inline bool operator<(const Time &lhs, const Time &rhs)
 {
-    return lhs.get_total_minutes() < rhs.get_total_minutes();
+    return lhs.get_ticks() < rhs.get_ticks();
 }
 
 inline bool operator>(const Time &lhs, const Time &rhs) { return rhs < lhs; }
@@ -26,4 +26,78 @@
 
 namespace growth
 {
+
+CompactGeometry::CompactGeometry(const BPolygon &polygon)
+    : Geometry(true)
+    , offsets()
+{
+    const BRing &ring = polygon.outer();
+
+    num_vertices = ring.size() - 1;
+
+    x0 = ring[0].x();
+    y0 = ring[0].y();
+
+    for (unsigned char i = 1; i < num_vertices; i++)
+    {
+        offsets[2 * i - 2] = static_cast<float>(ring[i].x() - x0);
+        offsets[2 * i - 1] = static_cast<float>(ring[i].y() - y0);
+    }
+}
+
+
+/**
+ * @brief Whether `polygon` is a closed triangle or quadrilateral without
+ * holes (as the neurite segments).
+ */
+bool CompactGeometry::fits(const BPolygon &polygon)
+{
+    const BRing &ring = polygon.outer();
+
+    return polygon.inners().empty() and
+           (ring.size() == 4 or ring.size() == 5) and
+           bg::equals(ring.front(), ring.back());
+}
+
+
+BPolygonPtr CompactGeometry::polygon() const
+{
+    BPolygonPtr poly = std::make_shared<BPolygon>();
+    BRing &ring      = poly->outer();
+
+    ring.reserve(num_vertices + 1);
+    ring.push_back(BPoint(x0, y0));
+
+    for (unsigned char i = 1; i < num_vertices; i++)
+    {
+        ring.push_back(
+            BPoint(x0 + offsets[2 * i - 2], y0 + offsets[2 * i - 1]));
+    }
+
+    ring.push_back(BPoint(x0, y0));
+
+    return poly;
+}
+
+
+/**
+ * Full geometries share their polygon (same pointer at each call), compact
+ * ones return a new polygon.
+ */
+BPolygonPtr get_polygon(const GeometryPtr &geom)
+{
+    if (geom == nullptr)
+    {
+        return nullptr;
+    }
+
+    if (geom->compact)
+    {
+        return static_cast<const CompactGeometry *>(geom.get())->polygon();
+    }
+
+    // aliasing constructor: the polygon shares the ownership of `geom`
+    return BPolygonPtr(geom, &static_cast<FullGeometry *>(geom.get())->polygon);
+}
+
 } // namespace growth
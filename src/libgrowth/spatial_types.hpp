@@ -0,0 +1,229 @@
+#ifndef SPATIAL_TYPES_H
+#define SPATIAL_TYPES_H
+#ifndef GEOS_USE_ONLY_R_API
+#define GEOS_USE_ONLY_R_API
+#endif
+
+// define whether Boost is greater than 1.67
+#define BOOST_1_67_PLUS
+
+// C++ include
+#include <array>
+#include <cmath>
+#include <memory>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+// Boost includes
+#ifndef BOOST_1_67_PLUS
+#include <boost/functional/hash.hpp>
+#else
+#include <boost/container_hash/hash.hpp>
+#endif
+
+#include <boost/geometry.hpp>
+#include <boost/geometry/geometries/geometries.hpp>
+#include <boost/geometry/geometries/point_xy.hpp>
+#include <boost/range/iterator_range.hpp>
+#include <boost/range/join.hpp>
+
+// include GEOS C-API
+#include <geos_c.h>
+
+#include "config.hpp"
+
+
+namespace bg  = boost::geometry;
+namespace bgi = boost::geometry::index;
+
+
+namespace growth
+{
+
+/*
+ * Boost objects
+ */
+
+typedef bg::model::d2::point_xy<double> BPoint;
+typedef bg::model::multi_point<BPoint> BMultiPoint;
+typedef bg::model::segment<BPoint> BSegment;
+typedef bg::model::linestring<BPoint> BLineString;
+typedef bg::model::multi_linestring<BLineString> BMultiLineString;
+typedef bg::model::ring<BPoint> BRing;
+typedef bg::model::polygon<BPoint> BPolygon;
+typedef bg::model::multi_polygon<BPolygon> BMultiPolygon;
+typedef bg::model::box<BPoint> BBox;
+
+typedef boost::variant<BPolygon, BMultiPolygon> BGeometry;
+
+typedef std::shared_ptr<BPolygon> BPolygonPtr;
+typedef std::shared_ptr<BMultiPolygon> BMultiPolygonPtr;
+typedef std::shared_ptr<BGeometry> BGeometryPtr;
+
+
+//! segments of a branch, in order
+typedef std::vector<BPolygonPtr> seg_range;
+
+
+/*
+ * Stored geometries
+ */
+
+/**
+ * @brief Polygon of a soma or of a neurite segment, as stored by the branches
+ * and the space manager.
+ *
+ * With the ``compact_geometry`` kernel parameter, the segment polygons
+ * (triangles or quadrilaterals) are stored as CompactGeometry objects and
+ * rebuilt on demand by `get_polygon`.
+ */
+struct Geometry
+{
+    Geometry(bool compact_)
+        : compact(compact_)
+    {
+    }
+
+    bool compact;
+};
+
+
+//! Geometry storing the polygon itself
+struct FullGeometry : public Geometry
+{
+    FullGeometry()
+        : Geometry(false)
+    {
+    }
+
+    BPolygon polygon;
+};
+
+
+/**
+ * @brief Geometry storing the first vertex of a triangle or quadrilateral and
+ * the other vertices as float offsets from it.
+ *
+ * It uses 48 bytes instead of about 200 for a polygon (its 5 vertices, its
+ * rings and their allocations); the error on the vertices is below 6e-8
+ * times the size of the segment.
+ */
+struct CompactGeometry : public Geometry
+{
+    CompactGeometry(const BPolygon &polygon);
+
+    static bool fits(const BPolygon &polygon);
+    BPolygonPtr polygon() const;
+
+    unsigned char num_vertices;    // without the closing vertex
+    std::array<float, 6> offsets;  // x, y of the other vertices
+    double x0, y0;                 // first vertex
+};
+
+
+typedef std::shared_ptr<Geometry> GeometryPtr;
+
+//! Polygon of a stored geometry (nullptr if `geom` is null)
+BPolygonPtr get_polygon(const GeometryPtr &geom);
+
+
+/*
+ * Smart pointers
+ */
+
+class Area;
+typedef std::shared_ptr<Area> AreaPtr;
+
+
+/*
+ * Geometrical objects
+ */
+
+typedef std::vector<double> Vector;
+typedef std::array<double, 3> PointArray;
+typedef std::array<Vector, 3> PointsArray;
+
+
+/*
+ * Growth cone motion
+ */
+
+typedef struct Filopodia
+{
+    std::vector<double> directions;
+    std::vector<double> normal_weights;
+    int size;
+    double finger_length;
+    double substrate_affinity;
+    double wall_affinity;
+} Filopodia;
+
+
+typedef struct Move
+{
+    BPoint position;
+    double module;
+    double speed;
+    double angle;
+    double sigma_angle;
+    Move()
+        : position(BPoint())
+        , module(0)
+        , speed(0)
+        , angle(0)
+        , sigma_angle(0)
+    {
+    }
+} Move;
+
+
+/*
+ * R-tree and ppatial object description into tuple and hash function
+ */
+
+// ObjectInfo tuple (neuron ID, neurite name, node ID, index on branch)
+typedef std::tuple<stype, std::string, stype, stype> ObjectInfo;
+
+
+namespace ndata
+{
+enum ndata
+{
+    NEURON,
+    NEURITE,
+    NODE,
+    SEGMENT
+};
+}
+
+
+// R-tree value
+typedef std::pair<BBox, ObjectInfo> RtreeValue;
+
+typedef std::unordered_map<ObjectInfo, BPolygonPtr, boost::hash<ObjectInfo>>
+    space_tree_map;
+
+typedef std::unordered_map<ObjectInfo, GeometryPtr, boost::hash<ObjectInfo>>
+    geometry_map;
+
+typedef std::tuple<ObjectInfo, BBox, bool> box_tree_tuple;
+
+
+/*
+ * Synapses
+ */
+
+typedef std::vector<std::pair<stype, stype>> synapse_vec;
+typedef std::vector<std::tuple<std::string, stype, stype>> synapse_ref;
+
+// segment polygons dilated by the spine length, computed once per call
+typedef std::unordered_map<ObjectInfo, BPolygon, boost::hash<ObjectInfo>>
+    dilated_segment_map;
+
+typedef boost::range::joined_range<std::vector<BPoint>, std::vector<BPoint>>
+    point_range;
+
+} // namespace growth
+
+#endif /* SPATIAL_TYPES_H */
@@ -82,6 +82,7 @@ class GrowthConeModel : public virtual GrowthCone
     void update_growth_properties(const std::string &area_name) override final;
     inline void update_speed(double update_factor) override final;
     inline double get_max_speed() override final;
+    ExtensionModel *get_elongator() const override final;
 
     void
     compute_direction_probabilities(std::vector<double> &directions_weights,
@@ -221,6 +222,18 @@ void GrowthConeModel<ElType, SteerMethod, DirSelMethod>::compute_speed(
 }
 
 
+/**
+ * @brief access the extension model (used by the neurite for collective
+ * dynamics such as the resource-based competition).
+ */
+template <class ElType, class SteerMethod, class DirSelMethod>
+ExtensionModel *
+GrowthConeModel<ElType, SteerMethod, DirSelMethod>::get_elongator() const
+{
+    return elongator_.get();
+}
+
+
 /**
  * @brief use the `steerer_` member to evaluate the probability of each angle.
  */
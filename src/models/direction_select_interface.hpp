@@ -102,7 +102,7 @@ class DirectionSelectModel
     virtual void prepare_for_split(){};
     virtual void after_split(){};
     virtual void kernel_updated(){};
-    virtual double get_state(const std::string &observable) const
+    virtual double get_state(const std::string &/*observable*/) const
     {
         return std::nan("");
     };
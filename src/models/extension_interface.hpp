@@ -99,7 +99,7 @@ class ExtensionModel
     virtual void prepare_for_split(){};
     virtual void after_split(){};
 
-    virtual double get_state(const std::string &observable) const
+    virtual double get_state(const std::string &/*observable*/) const
     {
         return std::nan("");
     };
@@ -122,36 +122,29 @@ void ResourceBasedExtensionModel::prepare_for_split()
 void ResourceBasedExtensionModel::after_split() {}
 
 
-void ResourceBasedExtensionModel::compute_res_received(double substep)
-{
-    received_ = neurite_ptr_->get_available_cr() *
-                // local demand (weighted)
-                get_res_demand() *
-                // normalization factor for the neurite
-                neurite_ptr_->get_quotient_cr();
-}
-
-
 /**
  * @brief Compute the demand of CR at the actual step
  *
- * @param rnd_engine
+ * Called by the Neurite, which gathers the demands of all its growth cones
+ * to compute the amount each one receives (see
+ * :cpp:func:`Neurite::update_growth_cones`).
+ *
+ * @param centrifugal_order order of the growth cone
+ * @param diameter diameter of the growth cone
  *
  * @return res_demand
  */
-double ResourceBasedExtensionModel::get_res_demand()
+double ResourceBasedExtensionModel::get_res_demand(int centrifugal_order,
+                                                   double diameter) const
 {
     double current_demand = stored_ * consumption_rate_;
     // weight by centrifugal order and diameter if required
     if (weight_centrifugal_ > 0)
     {
-        current_demand *=
-            powf(2, -weight_centrifugal_ *
-                        gc_weakptr_.lock()->get_centrifugal_order());
+        current_demand *= std::exp2(-weight_centrifugal_ * centrifugal_order);
     }
     if (weight_diameter_ > 0)
     {
-        double diameter = gc_weakptr_.lock()->get_diameter();
         current_demand *= (1 + weight_diameter_ * diameter * diameter);
     }
 
@@ -213,14 +206,17 @@ double ResourceBasedExtensionModel::get_max_speed() const
 }
 
 
+/**
+ * @brief Update the resource stored in the growth cone
+ *
+ * The amount received from the neurite (`received_`) must have been set
+ * beforehand by :cpp:func:`Neurite::update_growth_cones`.
+ */
 double ResourceBasedExtensionModel::compute_CR(mtPtr rnd_engine, double substep,
                                                double step_length, bool stuck)
 {
     if (not stuck)
     {
-        // compute received CR from the soma, with respect to other GC.
-        compute_res_received(substep);
-
         // correlated gaussian (unit standard deviation)
         noise_ =
             noise_ * correlation_ + sqrt_corr_ * normal_(*(rnd_engine).get());
@@ -230,14 +226,13 @@ double ResourceBasedExtensionModel::compute_CR(mtPtr rnd_engine, double substep,
                   substep * (received_ - stored_ * consumption_rate_) +
                   sqrt(substep) * variance_ * noise_;
 
-        double branch_length = gc_weakptr_.lock()->get_branch()->get_length();
-
         // amount of molecule cannot be negative
         if (stored_ < 0.)
         {
             stored_ = 0.;
         }
-        else if (stored_ > branching_th_ and branch_length > step_length)
+        else if (stored_ > branching_th_ and
+                 gc_weakptr_.lock()->get_branch()->get_length() > step_length)
         {
             double rnd_throw = uniform_(*(rnd_engine).get());
             double threshold = branching_proba_ * (stored_ - branching_th_) /
@@ -246,16 +241,24 @@ double ResourceBasedExtensionModel::compute_CR(mtPtr rnd_engine, double substep,
             if (rnd_throw < substep * threshold)
             {
                 // create an event so the growth cone will split at the next
-                // step
-                Time ev_time = kernel().simulation_manager.get_time();
-                ev_time.update(1UL, 0.);
+                // step (converted from the absolute step count)
+                const Time &t0 =
+                    kernel().simulation_manager.get_initial_time();
+                Time::timeStep step;
+                double ev_substep;
+
+                Time::to_steps(kernel().simulation_manager.get_time() - t0,
+                               step, ev_substep);
+
+                Time ev_time = t0;
+                ev_time.update(step + 1, ev_substep);
 
-                auto neuron         = neurite_ptr_->get_parent_neuron().lock();
-                stype neuron_gid    = neuron->get_gid();
-                std::string neurite = neurite_ptr_->get_name();
-                int cone_id         = gc_weakptr_.lock()->get_node_id();
+                auto neuron      = neurite_ptr_->get_parent_neuron().lock();
+                stype neuron_gid = neuron->get_gid();
+                stype neurite_id = neurite_ptr_->get_id();
+                int cone_id      = gc_weakptr_.lock()->get_node_id();
 
-                Event ev = std::make_tuple(ev_time, neuron_gid, neurite,
+                Event ev = std::make_tuple(ev_time, neuron_gid, neurite_id,
                                            cone_id, names::gc_splitting);
 
                 kernel().simulation_manager.new_branching_event(ev);
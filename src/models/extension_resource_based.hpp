@@ -82,13 +82,12 @@ class ResourceBasedExtensionModel : public virtual ExtensionModel
     void update_local_speed(double area_factor) override final;
     double get_max_speed() const override final;
 
-    void compute_res_received(double substep);
     double compute_CR(mtPtr rnd_engine, double substep, double step_length,
                       bool stuck);
 
     // getter functions
     void printinfo() const;
-    double get_res_demand();
+    double get_res_demand(int centrifugal_order, double diameter) const;
     double get_res_received() const;
     double get_res_speed_factor() const;
     double get_speed() const;
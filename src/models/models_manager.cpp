@@ -0,0 +1,360 @@
+#include "models_manager.hpp"
+
+#include <sstream>
+
+// Include from kernel
+#include "kernel_manager.hpp"
+
+// Include from libgrowth
+#include "elements_types.hpp"
+
+// Include from elements
+#include "GrowthCone.hpp"
+
+// Include from models
+#include "complete_gc_model.hpp"
+// extension methods
+#include "extension_cst.hpp"
+#include "extension_gfluct.hpp"
+#include "extension_resource_based.hpp"
+// steering methods
+#include "steering_pull_only.hpp"
+#include "steering_memory_based.hpp"
+#include "steering_srf.hpp"
+// direction selection methods
+#include "direction_select_nm.hpp"
+#include "direction_select_nwa.hpp"
+#include "direction_select_rt.hpp"
+
+
+
+namespace growth
+{
+
+ModelManager::ModelManager()
+  : extension_types({
+      "constant",
+      "gaussian-fluctuations",
+      "resource-based",
+    })
+  , steering_methods({
+      "pull-only",
+      "memory-based",
+      "self-referential-forces",
+    })
+  , direction_selection({
+      "noisy-maximum",
+      "noisy-weighted-average",
+      "run-and-tumble",
+    })
+  , abbrev_to_full({
+      {"cst", "constant"},
+      {"gf", "gaussian-fluctuations"},
+      {"res", "resource-based"},
+      {"po", "pull-only"},
+      {"mem", "memory-based"},
+      {"srf", "self-referential-forces"},
+      {"nm", "noisy-maximum"},
+      {"nwa", "noisy-weighted-average"},
+      {"rt", "run-and-tumble"},
+    })
+  , full_to_abbrev({
+      {"constant", "cst"},
+      {"gaussian-fluctuations", "gf"},
+      {"resource-based", "res"},
+      {"pull-only", "po"},
+      {"memory-based", "mem"},
+      {"self-referential-forces", "srf"},
+      {"noisy-maximum", "nm"},
+      {"noisy-weighted-average", "nwa"},
+      {"run-and-tumble", "rt"},
+    })
+  , specials({
+      {"simple-random-walk", "constant_pull-only_noisy-weighted-average"},
+      {"run-and-tumble", "constant_pull-only_run-and-tumble"},
+      {"netmorph-like", "constant_memory-based_noisy-maximum"},
+      {"self-referential-forces", "constant_self-referential-forces_noisy-weighted-average"},
+    })
+  , default_model("run-and-tumble")
+{
+}
+
+
+void ModelManager::init_models()
+{
+    models_.insert({
+        "constant_pull-only_noisy-maximum",
+        GrowthConeModel<CstExtensionModel, PullOnlySteeringModel, NMDirectionSelector>::create_gc_model("constant_pull-only_noisy-maximum")
+    });
+
+    models_.insert({
+        "constant_pull-only_noisy-weighted-average",
+        GrowthConeModel<CstExtensionModel, PullOnlySteeringModel, NWADirectionSelector>::create_gc_model("constant_pull-only_noisy-weighted-average")
+    });
+
+    models_.insert({
+        "constant_pull-only_run-and-tumble",
+        GrowthConeModel<CstExtensionModel, PullOnlySteeringModel, RTDirectionSelector>::create_gc_model("constant_pull-only_run-and-tumble")
+    });
+
+    models_.insert({
+        "constant_memory-based_noisy-maximum",
+        GrowthConeModel<CstExtensionModel, MemBasedSteeringModel, NMDirectionSelector>::create_gc_model("constant_memory-based_noisy-maximum")
+    });
+
+    models_.insert({
+        "constant_memory-based_noisy-weighted-average",
+        GrowthConeModel<CstExtensionModel, MemBasedSteeringModel, NWADirectionSelector>::create_gc_model("constant_memory-based_noisy-weighted-average")
+    });
+
+    models_.insert({
+        "constant_memory-based_run-and-tumble",
+        GrowthConeModel<CstExtensionModel, MemBasedSteeringModel, RTDirectionSelector>::create_gc_model("constant_memory-based_run-and-tumble")
+    });
+
+    models_.insert({
+        "constant_self-referential-forces_noisy-maximum",
+        GrowthConeModel<CstExtensionModel, SrfSteeringModel, NMDirectionSelector>::create_gc_model("constant_self-referential-forces_noisy-maximum")
+    });
+
+    models_.insert({
+        "constant_self-referential-forces_noisy-weighted-average",
+        GrowthConeModel<CstExtensionModel, SrfSteeringModel, NWADirectionSelector>::create_gc_model("constant_self-referential-forces_noisy-weighted-average")
+    });
+
+    models_.insert({
+        "constant_self-referential-forces_run-and-tumble",
+        GrowthConeModel<CstExtensionModel, SrfSteeringModel, RTDirectionSelector>::create_gc_model("constant_self-referential-forces_run-and-tumble")
+    });
+
+    models_.insert({
+        "gaussian-fluctuations_pull-only_noisy-maximum",
+        GrowthConeModel<GFluctExtensionModel, PullOnlySteeringModel, NMDirectionSelector>::create_gc_model("gaussian-fluctuations_pull-only_noisy-maximum")
+    });
+
+    models_.insert({
+        "gaussian-fluctuations_pull-only_noisy-weighted-average",
+        GrowthConeModel<GFluctExtensionModel, PullOnlySteeringModel, NWADirectionSelector>::create_gc_model("gaussian-fluctuations_pull-only_noisy-weighted-average")
+    });
+
+    models_.insert({
+        "gaussian-fluctuations_pull-only_run-and-tumble",
+        GrowthConeModel<GFluctExtensionModel, PullOnlySteeringModel, RTDirectionSelector>::create_gc_model("gaussian-fluctuations_pull-only_run-and-tumble")
+    });
+
+    models_.insert({
+        "gaussian-fluctuations_memory-based_noisy-maximum",
+        GrowthConeModel<GFluctExtensionModel, MemBasedSteeringModel, NMDirectionSelector>::create_gc_model("gaussian-fluctuations_memory-based_noisy-maximum")
+    });
+
+    models_.insert({
+        "gaussian-fluctuations_memory-based_noisy-weighted-average",
+        GrowthConeModel<GFluctExtensionModel, MemBasedSteeringModel, NWADirectionSelector>::create_gc_model("gaussian-fluctuations_memory-based_noisy-weighted-average")
+    });
+
+    models_.insert({
+        "gaussian-fluctuations_memory-based_run-and-tumble",
+        GrowthConeModel<GFluctExtensionModel, MemBasedSteeringModel, RTDirectionSelector>::create_gc_model("gaussian-fluctuations_memory-based_run-and-tumble")
+    });
+
+    models_.insert({
+        "gaussian-fluctuations_self-referential-forces_noisy-maximum",
+        GrowthConeModel<GFluctExtensionModel, SrfSteeringModel, NMDirectionSelector>::create_gc_model("gaussian-fluctuations_self-referential-forces_noisy-maximum")
+    });
+
+    models_.insert({
+        "gaussian-fluctuations_self-referential-forces_noisy-weighted-average",
+        GrowthConeModel<GFluctExtensionModel, SrfSteeringModel, NWADirectionSelector>::create_gc_model("gaussian-fluctuations_self-referential-forces_noisy-weighted-average")
+    });
+
+    models_.insert({
+        "gaussian-fluctuations_self-referential-forces_run-and-tumble",
+        GrowthConeModel<GFluctExtensionModel, SrfSteeringModel, RTDirectionSelector>::create_gc_model("gaussian-fluctuations_self-referential-forces_run-and-tumble")
+    });
+
+    models_.insert({
+        "resource-based_pull-only_noisy-maximum",
+        GrowthConeModel<ResourceBasedExtensionModel, PullOnlySteeringModel, NMDirectionSelector>::create_gc_model("resource-based_pull-only_noisy-maximum")
+    });
+
+    models_.insert({
+        "resource-based_pull-only_noisy-weighted-average",
+        GrowthConeModel<ResourceBasedExtensionModel, PullOnlySteeringModel, NWADirectionSelector>::create_gc_model("resource-based_pull-only_noisy-weighted-average")
+    });
+
+    models_.insert({
+        "resource-based_pull-only_run-and-tumble",
+        GrowthConeModel<ResourceBasedExtensionModel, PullOnlySteeringModel, RTDirectionSelector>::create_gc_model("resource-based_pull-only_run-and-tumble")
+    });
+
+    models_.insert({
+        "resource-based_memory-based_noisy-maximum",
+        GrowthConeModel<ResourceBasedExtensionModel, MemBasedSteeringModel, NMDirectionSelector>::create_gc_model("resource-based_memory-based_noisy-maximum")
+    });
+
+    models_.insert({
+        "resource-based_memory-based_noisy-weighted-average",
+        GrowthConeModel<ResourceBasedExtensionModel, MemBasedSteeringModel, NWADirectionSelector>::create_gc_model("resource-based_memory-based_noisy-weighted-average")
+    });
+
+    models_.insert({
+        "resource-based_memory-based_run-and-tumble",
+        GrowthConeModel<ResourceBasedExtensionModel, MemBasedSteeringModel, RTDirectionSelector>::create_gc_model("resource-based_memory-based_run-and-tumble")
+    });
+
+    models_.insert({
+        "resource-based_self-referential-forces_noisy-maximum",
+        GrowthConeModel<ResourceBasedExtensionModel, SrfSteeringModel, NMDirectionSelector>::create_gc_model("resource-based_self-referential-forces_noisy-maximum")
+    });
+
+    models_.insert({
+        "resource-based_self-referential-forces_noisy-weighted-average",
+        GrowthConeModel<ResourceBasedExtensionModel, SrfSteeringModel, NWADirectionSelector>::create_gc_model("resource-based_self-referential-forces_noisy-weighted-average")
+    });
+
+    models_.insert({
+        "resource-based_self-referential-forces_run-and-tumble",
+        GrowthConeModel<ResourceBasedExtensionModel, SrfSteeringModel, RTDirectionSelector>::create_gc_model("resource-based_self-referential-forces_run-and-tumble")
+    });
+}
+
+
+std::vector<std::string> ModelManager::get_extension_types()
+{
+    std::vector<std::string> keys;
+    keys.reserve(extension_types.size());
+
+    for(auto const& etype: extension_types)
+    {
+        keys.push_back(etype);
+        keys.push_back(full_to_abbrev.at(etype));
+    }
+
+    return keys;
+}
+
+
+std::vector<std::string> ModelManager::get_steering_methods()
+{
+    std::vector<std::string> keys;
+    keys.reserve(steering_methods.size());
+
+    for(auto const& smeth: steering_methods)
+    {
+        keys.push_back(smeth);
+        keys.push_back(full_to_abbrev.at(smeth));
+    }
+
+    return keys;
+}
+
+
+std::vector<std::string> ModelManager::get_direction_selection_methods()
+{
+    std::vector<std::string> keys;
+    keys.reserve(direction_selection.size());
+
+    for(auto const& dirsel: direction_selection)
+    {
+        keys.push_back(dirsel);
+        keys.push_back(full_to_abbrev.at(dirsel));
+    }
+
+    return keys;
+}
+
+
+void ModelManager::get_models(std::unordered_map<std::string, std::string> &models, bool abbrev)
+{
+
+    // special model names
+    for (auto const &it : specials)
+    {
+        models.insert({it.first, it.second});
+    }
+
+    // abbreviated names
+    std::string abbrev_name, full_name;
+
+    for (auto const& el : extension_types)
+    {
+        for (auto const& steer : steering_methods)
+        {
+            for (auto const& diresel : direction_selection)
+            {
+                abbrev_name = full_to_abbrev.at(el) + "_" + full_to_abbrev.at(steer) + "_" + full_to_abbrev.at(diresel);
+                full_name   = el + "_" + steer + "_" + diresel;
+
+                models.insert({abbrev_name, full_name});
+            }
+        }
+    }
+
+    // full names
+    if (not abbrev)
+    {
+        for (auto &it : models_)
+        {
+            models.insert({it.first, it.first});
+        }
+    }
+}
+
+
+GCPtr ModelManager::get_model(const std::string& name)
+{
+    auto it = models_.find(name);
+
+    std::string full_name(name);
+
+    if (name == "default")
+    {
+        full_name = default_model;
+    }
+
+    if (it != models_.end())
+    {
+        full_name = it->first;
+    }
+    else
+    {
+        auto special_it = specials.find(full_name);
+
+        if (special_it != specials.end())
+        {
+            full_name = special_it->second;
+        }
+        else
+        {
+            std::vector<std::string> tokens;
+            std::string token;
+            std::istringstream tokenStream(full_name);
+
+            while (std::getline(tokenStream, token, '_'))
+            {
+                tokens.push_back(token);
+            }
+
+            full_name = abbrev_to_full.at(tokens[0]) + "_" +
+                        abbrev_to_full.at(tokens[1]) + "_" +
+                        abbrev_to_full.at(tokens[2]);
+        }
+    }
+
+    it = models_.find(full_name);
+
+    if (it == models_.end())
+    {
+        throw std::invalid_argument("Model `" + full_name + "` does not exist.");
+    }
+
+    return models_[full_name];
+}
+
+
+GCPtr ModelManager::get_default_model()
+{
+    return get_model(default_model);
+}
+
+} // namespace growth
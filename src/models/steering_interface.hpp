@@ -101,7 +101,7 @@ class SteeringModel
     // Standard methods for growth cone, should not they
     virtual void prepare_for_split(){};
     virtual void after_split(){};
-    virtual double get_state(const std::string &observable) const
+    virtual double get_state(const std::string &/*observable*/) const
     {
         return std::nan("");
     };
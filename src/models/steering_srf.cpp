@@ -122,7 +122,7 @@ void SrfSteeringModel::compute_direction_probabilities(
     double weight, abs_angle, angle, gfactor, sangle, sfactor, distance, tmp;
     double inv_pi = 1. / M_PI;
     std::string nneurite;
-    stype nneuron, ngc;
+    stype nneuron, ngc, nseg;
     BPoint target_pos;
 
     for (unsigned int n = 0; n < filo.directions.size(); n++)
@@ -183,6 +183,13 @@ void SrfSteeringModel::compute_direction_probabilities(
                 nneuron  = std::get<0>(info);
                 nneurite = std::get<1>(info);
                 ngc      = std::get<2>(info);
+                nseg     = std::get<3>(info);
+
+                // node ids in the R-tree are keys, get the actual node
+                if (nneuron == neuron_id and nneurite == neurite)
+                {
+                    neurite_ptr_->segment_position(ngc, nseg);
+                }
 
                 // SRF avoidance is only interactions with other growth cones
                 // //// of the same neuron
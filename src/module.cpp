@@ -27,7 +27,9 @@
 #include <cmath>
 #include <cstdlib>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
+#include <unordered_set>
 
 #include <boost/range/adaptor/strided.hpp>
 
@@ -90,8 +92,8 @@ stype create_objects_(const std::string &object_name,
  * @return the gid of the neuron created.
  */
 stype create_neurons_(
-    const std::vector<statusMap> &neuron_params,
-    const std::unordered_map<std::string, std::vector<statusMap>> &neurite_params)
+    const StatusTable &neuron_params,
+    const std::unordered_map<std::string, StatusTable> &neurite_params)
 {
     stype num_created = kernel().neuron_manager.create_neurons(neuron_params,
                                                                neurite_params);
@@ -125,33 +127,23 @@ void create_neurites_(
         std::string gc_model;
         bool gc_model_set;
         GCPtr gc_ptr;
+        const statusMap empty_status;
 
         // loop neurites/params
         for (const std::string &name : names)
         {
             auto it = params.find(name);
 
-            std::vector<statusMap> vec_statuses;
-
             if (it == params.end())
             {
                 it = params.find("dendrites");
-
-                if (it == params.end())
-                {
-                    vec_statuses =
-                        std::vector<statusMap>(omp_neuron_vec[omp_id].size());
-                }
-                else
-                {
-                    vec_statuses = it->second;
-                }
-            }
-            else
-            {
-                vec_statuses = it->second;
             }
 
+            // statuses are not copied, neurons without specific parameters
+            // get an empty status
+            const std::vector<statusMap> *vec_statuses =
+                (it == params.end()) ? nullptr : &(it->second);
+
             // loop neurons
             for (stype i : omp_neuron_vec[omp_id])
             {
@@ -161,7 +153,9 @@ void create_neurites_(
                 // update angles
                 neuron->update_angles(angles);
 
-                statusMap status = vec_statuses[i];
+                const statusMap &status =
+                    (vec_statuses == nullptr) ? empty_status
+                                              : (*vec_statuses)[i];
 
                 stype existing_neurites = neuron->get_num_neurites();
                 bool has_axon           = neuron->has_axon();
@@ -193,6 +187,14 @@ void create_neurites_(
 
 void delete_neurons_(const std::vector<stype> &gids)
 {
+    // remove the segments and pending events of the neurons in one pass
+    std::vector<stype> deleted =
+        gids.empty() ? kernel().neuron_manager.get_gids() : gids;
+    std::unordered_set<stype> gid_set(deleted.begin(), deleted.end());
+
+    kernel().space_manager.remove_neurons(gid_set);
+    kernel().simulation_manager.neurons_deleted(gid_set);
+
     if (gids.empty())
     {
         kernel().neuron_manager.finalize();
@@ -214,26 +216,68 @@ void delete_neurons_(const std::vector<stype> &gids)
 void delete_neurites_(const std::vector<stype> &gids,
                       const std::vector<std::string> &names)
 {
+    std::vector<NeuronPtr> neurons;
+
     if (gids.empty())
     {
-        std::vector<NeuronPtr> neurons;
-
         kernel().neuron_manager.get_all_neurons(neurons);
-
-        for (NeuronPtr neuron : neurons)
+    }
+    else
+    {
+        for (stype gid : gids)
         {
-            neuron->delete_neurites(names);
+            NeuronPtr neuron = kernel().neuron_manager.get_neuron(gid);
+
+            if (neuron == nullptr)
+            {
+                throw InvalidArg("Neuron " + std::to_string(gid) +
+                                     " does not exist.",
+                                 __FUNCTION__, __FILE__, __LINE__);
+            }
+
+            neurons.push_back(neuron);
         }
     }
-    else
+
+    // get the deleted neurites (and check that they exist) to remove all
+    // their segments from space in one pass
+    std::unordered_map<stype, std::unordered_set<std::string>> deleted;
+
+    for (NeuronPtr neuron : neurons)
     {
-        for (stype neuron : gids)
+        std::unordered_set<std::string> existing;
+
+        for (auto it = neuron->neurite_cbegin(); it != neuron->neurite_cend();
+             it++)
+        {
+            existing.insert(it->first);
+        }
+
+        for (const auto &name : names)
         {
-            NeuronPtr nptr = kernel().neuron_manager.get_neuron(neuron);
+            if (existing.find(name) == existing.end())
+            {
+                throw std::runtime_error("Neurite '" + name +
+                                         "' does not exist.");
+            }
+        }
 
-            nptr->delete_neurites(names);
+        if (names.empty())
+        {
+            deleted[neuron->get_gid()] = std::move(existing);
+        }
+        else
+        {
+            deleted[neuron->get_gid()].insert(names.begin(), names.end());
         }
     }
+
+    kernel().space_manager.remove_neurites(deleted);
+
+    for (NeuronPtr neuron : neurons)
+    {
+        neuron->delete_neurites(names);
+    }
 }
 
 
@@ -314,20 +358,20 @@ void set_kernel_status_(const statusMap &status_dict, std::string simulation_ID)
 }
 
 
-void set_status_(stype gid, statusMap neuron_status,
-                 std::unordered_map<std::string, statusMap> neurite_statuses)
+void set_status_(
+    stype gid, const statusMap &neuron_status,
+    const std::unordered_map<std::string, statusMap> &neurite_statuses)
 {
-    // @todo: do this in parallel
     auto neuron = kernel().neuron_manager.get_neuron(gid);
     neuron->set_status(neuron_status);
 
     statusMap local_params;
 
-    for (auto entry : neurite_statuses)
+    for (const auto &entry : neurite_statuses)
     {
         local_params = neuron_status;
 
-        for (auto &param : entry.second)
+        for (const auto &param : entry.second)
         {
             local_params[param.first] = param.second;
         }
@@ -335,7 +379,7 @@ void set_status_(stype gid, statusMap neuron_status,
         // check for placeholder "dendrites" entry
         if (entry.first == "dendrites")
         {
-            for (auto neurite : get_neurites_(gid))
+            for (const auto &neurite : get_neurites_(gid))
             {
                 neuron->set_neurite_status(neurite, local_params);
             }
@@ -351,77 +395,108 @@ void set_status_(stype gid, statusMap neuron_status,
 }
 
 
-void set_status_(std::vector<stype> gids, std::vector<statusMap> status,
-                 std::unordered_map<std::string, std::vector<statusMap>>
-                     neurite_statuses)
+/**
+ * @brief Update the status of several neurons in parallel.
+ *
+ * The neurite statuses are made of the neuron parameters, overwritten by the
+ * neurite-specific ones.
+ */
+void set_status_(
+    const std::vector<stype> &gids, const StatusTable &status,
+    const std::unordered_map<std::string, StatusTable> &neurite_statuses)
 {
-    // get the threads of the neurons
-    std::unordered_map<int, std::vector<stype>> map_thread_gids;
-    std::unordered_map<int, std::vector<stype>> map_thread_idx;
-    int thread_id;
-    stype i(0);
+    // get the neurons of each thread (as indices in `gids`)
+    int num_omp = kernel().parallelism_manager.get_num_local_threads();
+    std::vector<std::vector<stype>> thread_idx(num_omp);
 
-    for (stype gid : gids)
+    for (stype i = 0; i < gids.size(); i++)
     {
-        thread_id = kernel().neuron_manager.get_neuron_thread(gid);
-
-        auto it = map_thread_gids.find(thread_id);
+        int omp_id = kernel().neuron_manager.get_neuron_thread(gids[i]);
+        thread_idx[omp_id].push_back(i);
+    }
 
-        if (it == map_thread_gids.end())
-        {
-            map_thread_gids[thread_id] = std::vector<stype>({gid});
-            map_thread_idx[thread_id] = std::vector<stype>({i});
-        }
-        else
-        {
-            map_thread_gids[thread_id].push_back(gid);
-            map_thread_idx[thread_id].push_back(i);
-        }
+    // merge neuron and neurite parameters once for all neurons
+    std::vector<std::string> neurite_names;
+    std::vector<StatusTable> neurite_tables;
 
-        i++;
+    for (const auto &entry : neurite_statuses)
+    {
+        neurite_names.push_back(entry.first);
+        neurite_tables.push_back(status);
+        neurite_tables.back().update(entry.second);
     }
 
+    // exception_capture_flag "guards" captured_exception. std::called_once()
+    // guarantees that will only execute any of its Callable(s) ONCE for each
+    // unique std::once_flag. See C++11 Standard Library documentation
+    // (``<mutex>``). These tools together ensure that we can capture exceptions
+    // from OpenMP parallel regions in a thread-safe way.
+    std::once_flag exception_capture_flag;
+    // pointer-like object that manages an exception captured with
+    // std::capture_exception(). We use this to capture exceptions thrown from
+    // the OpenMP parallel region.
+    std::exception_ptr captured_exception;
+
 #pragma omp parallel
     {
         int omp_id = kernel().parallelism_manager.get_thread_local_id();
 
-        auto it = map_thread_gids.find(omp_id);
+        statusMap neuron_status;
+        std::vector<Property *> neuron_slots;
+        std::vector<statusMap> neurite_status(neurite_tables.size());
+        std::vector<std::vector<Property *>> neurite_slots(
+            neurite_tables.size());
+
+        status.prepare(neuron_status, neuron_slots);
+
+        for (stype k = 0; k < neurite_tables.size(); k++)
+        {
+            neurite_tables[k].prepare(neurite_status[k], neurite_slots[k]);
+        }
 
-        if (it != map_thread_gids.end())
+        try
         {
-            for (i=0; i < map_thread_gids[omp_id].size(); i++)
+            for (stype i : thread_idx[omp_id])
             {
                 auto neuron = kernel().neuron_manager.get_neuron(gids[i]);
-                neuron->set_status(status[i]);
 
-                statusMap local_params;
+                status.fill(i, neuron_slots);
+                neuron->set_status(neuron_status);
 
-                for (auto entry : neurite_statuses)
+                for (stype k = 0; k < neurite_tables.size(); k++)
                 {
-                    local_params = status[i];
-
-                    for (auto &param : entry.second[i])
-                    {
-                        local_params[param.first] = param.second;
-                    }
+                    neurite_tables[k].fill(i, neurite_slots[k]);
 
                     // check for placeholder "dendrites" entry
-                    if (entry.first == "dendrites")
+                    if (neurite_names[k] == "dendrites")
                     {
-                        for (auto neurite : get_neurites_(gids[i]))
+                        for (const auto &neurite : get_neurites_(gids[i]))
                         {
                             neuron->set_neurite_status(neurite,
-                                                       local_params);
+                                                       neurite_status[k]);
                         }
                     }
                     else
                     {
-                        neuron->set_neurite_status(entry.first,
-                                                   local_params);
+                        neuron->set_neurite_status(neurite_names[k],
+                                                   neurite_status[k]);
                     }
                 }
             }
         }
+        catch (const std::exception &except)
+        {
+            std::call_once(exception_capture_flag, [&captured_exception]() {
+                captured_exception = std::current_exception();
+            });
+        }
+    }
+
+    // check if an exception was thrown there
+    if (captured_exception != nullptr)
+    {
+        // rethrowing nullptr is illegal
+        std::rethrow_exception(captured_exception);
     }
 
     // update max_resolution for simulation
@@ -860,9 +935,9 @@ void get_geom_skeleton_(std::vector<stype> gids,
 
 void generate_synapses_(
     bool crossings_only, double density, bool only_new_syn,
-    bool autapse_allowed, const std::set<stype> &presyn_pop,
-    const std::set<stype> &postsyn_pop, std::vector<stype> &presyn_neurons,
-    std::vector<stype> &postsyn_neurons,
+    bool autapse_allowed, bool deterministic,
+    const std::set<stype> &presyn_pop, const std::set<stype> &postsyn_pop,
+    std::vector<stype> &presyn_neurons, std::vector<stype> &postsyn_neurons,
     std::vector<std::string> &presyn_neurites,
     std::vector<std::string> &postsyn_neurites,
     std::vector<stype> &presyn_nodes, std::vector<stype> &postsyn_nodes,
@@ -873,21 +948,285 @@ void generate_synapses_(
     if (crossings_only)
     {
         kernel().space_manager.generate_synapses_crossings(
-            density, only_new_syn, autapse_allowed, presyn_pop, postsyn_pop,
-            presyn_neurons, postsyn_neurons, presyn_neurites, postsyn_neurites,
-            presyn_nodes, postsyn_nodes, presyn_segments, postsyn_segments,
-            pre_syn_x, pre_syn_y);
-
-        post_syn_x = pre_syn_x;
-        post_syn_y = pre_syn_y;
+            density, only_new_syn, autapse_allowed, deterministic, presyn_pop,
+            postsyn_pop, presyn_neurons, postsyn_neurons, presyn_neurites,
+            postsyn_neurites, presyn_nodes, postsyn_nodes, presyn_segments,
+            postsyn_segments, pre_syn_x, pre_syn_y, post_syn_x, post_syn_y);
     }
     else
     {
         kernel().space_manager.generate_synapses_all(
-            density, only_new_syn, autapse_allowed, presyn_pop, postsyn_pop,
-            presyn_neurons, postsyn_neurons, presyn_neurites, postsyn_neurites,
-            presyn_nodes, postsyn_nodes, presyn_segments, postsyn_segments,
-            pre_syn_x, pre_syn_y, post_syn_x, post_syn_y);
+            density, only_new_syn, autapse_allowed, deterministic, presyn_pop,
+            postsyn_pop, presyn_neurons, postsyn_neurons, presyn_neurites,
+            postsyn_neurites, presyn_nodes, postsyn_nodes, presyn_segments,
+            postsyn_segments, pre_syn_x, pre_syn_y, post_syn_x, post_syn_y);
+    }
+}
+
+
+/*
+ * Distance soma -> contact -> soma for each contact (neurons that were
+ * deleted since are given a NaN distance)
+ */
+void get_soma_distances(const std::vector<stype> &presyn_neurons,
+                        const std::vector<stype> &postsyn_neurons,
+                        const std::vector<double> &contact_x,
+                        const std::vector<double> &contact_y,
+                        std::vector<double> &soma_distance)
+{
+    std::unordered_map<stype, BPoint> somas;
+
+    auto get_soma = [&somas](stype gid, BPoint &soma) {
+        auto it = somas.find(gid);
+
+        if (it == somas.end())
+        {
+            if (not kernel().neuron_manager.is_neuron(gid))
+            {
+                return false;
+            }
+
+            NeuronPtr neuron = kernel().neuron_manager.get_neuron(gid);
+            it = somas.emplace(gid, neuron->get_position()).first;
+        }
+
+        soma = it->second;
+
+        return true;
+    };
+
+    stype num_contacts = presyn_neurons.size();
+
+    soma_distance.resize(num_contacts);
+
+    BPoint pre_soma, post_soma;
+
+    for (stype i = 0; i < num_contacts; i++)
+    {
+        BPoint p(contact_x[i], contact_y[i]);
+
+        if (get_soma(presyn_neurons[i], pre_soma) and
+            get_soma(postsyn_neurons[i], post_soma))
+        {
+            soma_distance[i] =
+                bg::distance(pre_soma, p) + bg::distance(post_soma, p);
+        }
+        else
+        {
+            soma_distance[i] = std::nan("");
+        }
+    }
+}
+
+
+void get_contacts_(
+    double max_distance, bool autapse_allowed,
+    const std::set<stype> &presyn_pop, const std::set<stype> &postsyn_pop,
+    std::vector<stype> &presyn_neurons, std::vector<stype> &postsyn_neurons,
+    std::vector<std::string> &presyn_neurites,
+    std::vector<std::string> &postsyn_neurites,
+    std::vector<stype> &presyn_nodes, std::vector<stype> &postsyn_nodes,
+    std::vector<stype> &presyn_segments, std::vector<stype> &postsyn_segments,
+    std::vector<double> &contact_area, std::vector<double> &contact_x,
+    std::vector<double> &contact_y, std::vector<double> &soma_distance)
+{
+    kernel().space_manager.get_contacts(
+        max_distance, autapse_allowed, presyn_pop, postsyn_pop, presyn_neurons,
+        postsyn_neurons, presyn_neurites, postsyn_neurites, presyn_nodes,
+        postsyn_nodes, presyn_segments, postsyn_segments, contact_area,
+        contact_x, contact_y);
+
+    get_soma_distances(presyn_neurons, postsyn_neurons, contact_x, contact_y,
+                       soma_distance);
+}
+
+
+void get_contact_log_(
+    bool only_new, std::vector<stype> &presyn_neurons,
+    std::vector<stype> &postsyn_neurons,
+    std::vector<std::string> &presyn_neurites,
+    std::vector<std::string> &postsyn_neurites,
+    std::vector<stype> &presyn_nodes, std::vector<stype> &postsyn_nodes,
+    std::vector<stype> &presyn_segments, std::vector<stype> &postsyn_segments,
+    std::vector<double> &contact_area, std::vector<double> &contact_x,
+    std::vector<double> &contact_y, std::vector<double> &contact_time,
+    std::vector<double> &soma_distance)
+{
+    kernel().space_manager.get_contact_log(
+        only_new, presyn_neurons, postsyn_neurons, presyn_neurites,
+        postsyn_neurites, presyn_nodes, postsyn_nodes, presyn_segments,
+        postsyn_segments, contact_area, contact_x, contact_y, contact_time);
+
+    get_soma_distances(presyn_neurons, postsyn_neurons, contact_x, contact_y,
+                       soma_distance);
+}
+
+
+void get_overlaps_(
+    double max_distance, const std::vector<stype> &overlaps,
+    const std::vector<stype> &presyn_neurons,
+    const std::vector<stype> &postsyn_neurons,
+    const std::vector<std::string> &presyn_neurites,
+    const std::vector<std::string> &postsyn_neurites,
+    const std::vector<stype> &presyn_nodes,
+    const std::vector<stype> &postsyn_nodes,
+    const std::vector<stype> &presyn_segments,
+    const std::vector<stype> &postsyn_segments,
+    std::vector<double> &overlap_area, std::vector<double> &overlap_x,
+    std::vector<double> &overlap_y, std::vector<double> &soma_distance)
+{
+    kernel().space_manager.get_overlaps(
+        max_distance, overlaps, presyn_neurons, postsyn_neurons,
+        presyn_neurites, postsyn_neurites, presyn_nodes, postsyn_nodes,
+        presyn_segments, postsyn_segments, overlap_area, overlap_x, overlap_y);
+
+    // neurons of each overlap
+    std::vector<stype> pre_neurons(overlap_area.size()),
+        post_neurons(overlap_area.size());
+
+    for (stype i = 0; i < overlaps.size(); i++)
+    {
+        pre_neurons[overlaps[i]]  = presyn_neurons[i];
+        post_neurons[overlaps[i]] = postsyn_neurons[i];
+    }
+
+    get_soma_distances(pre_neurons, post_neurons, overlap_x, overlap_y,
+                       soma_distance);
+}
+
+
+/*
+ * Merge the synapses into weighted edges, returned in CSR format with
+ * respect to `nodes` (rows are the presynaptic neurons and the columns of
+ * each row are sorted)
+ */
+void aggregate_synapses_(const std::vector<stype> &nodes,
+                         const std::vector<stype> &presyn_neurons,
+                         const std::vector<stype> &postsyn_neurons,
+                         const std::vector<double> &distances,
+                         double unit_strength, std::vector<stype> &indptr,
+                         std::vector<stype> &indices,
+                         std::vector<double> &weights,
+                         std::vector<stype> &multiplicity,
+                         std::vector<double> &mean_distance)
+{
+    stype num_nodes    = nodes.size();
+    stype num_synapses = presyn_neurons.size();
+    bool with_distance = not distances.empty();
+
+    std::unordered_map<stype, stype> node_index;
+
+    for (stype i = 0; i < num_nodes; i++)
+    {
+        node_index[nodes[i]] = i;
+    }
+
+    auto get_index = [&node_index](stype gid) {
+        auto it = node_index.find(gid);
+
+        if (it == node_index.end())
+        {
+            throw std::invalid_argument("Neuron " + std::to_string(gid) +
+                                        " is not in `nodes`.");
+        }
+
+        return it->second;
+    };
+
+    // bucket the synapses by presynaptic neuron (counting sort)
+    std::vector<stype> sources(num_synapses), targets(num_synapses);
+    std::vector<stype> row_start(num_nodes + 1, 0);
+
+    for (stype s = 0; s < num_synapses; s++)
+    {
+        sources[s] = get_index(presyn_neurons[s]);
+        targets[s] = get_index(postsyn_neurons[s]);
+        row_start[sources[s] + 1]++;
+    }
+
+    for (stype i = 0; i < num_nodes; i++)
+    {
+        row_start[i + 1] += row_start[i];
+    }
+
+    std::vector<stype> order(num_synapses);
+    std::vector<stype> cursor(row_start.begin(), row_start.end() - 1);
+
+    for (stype s = 0; s < num_synapses; s++)
+    {
+        order[cursor[sources[s]]++] = s;
+    }
+
+    // sort each row by target and count the edges
+    std::vector<stype> row_edges(num_nodes, 0);
+
+#pragma omp parallel for schedule(dynamic)
+    for (long i = 0; i < static_cast<long>(num_nodes); i++)
+    {
+        auto first = order.begin() + row_start[i];
+        auto last  = order.begin() + row_start[i + 1];
+
+        std::sort(first, last, [&targets](stype lhs, stype rhs) {
+            return targets[lhs] < targets[rhs] or
+                   (targets[lhs] == targets[rhs] and lhs < rhs);
+        });
+
+        for (auto it = first; it != last; it++)
+        {
+            if (it == first or targets[*it] != targets[*(it - 1)])
+            {
+                row_edges[i]++;
+            }
+        }
+    }
+
+    indptr = std::vector<stype>(num_nodes + 1, 0);
+
+    for (stype i = 0; i < num_nodes; i++)
+    {
+        indptr[i + 1] = indptr[i] + row_edges[i];
+    }
+
+    stype num_edges = indptr.back();
+
+    indices      = std::vector<stype>(num_edges);
+    weights      = std::vector<double>(num_edges, 0.);
+    multiplicity = std::vector<stype>(num_edges, 0);
+    mean_distance =
+        std::vector<double>(with_distance ? num_edges : 0, 0.);
+
+    // merge the synapses of each edge
+#pragma omp parallel for schedule(dynamic)
+    for (long i = 0; i < static_cast<long>(num_nodes); i++)
+    {
+        long e = static_cast<long>(indptr[i]) - 1;
+
+        for (stype k = row_start[i]; k < row_start[i + 1]; k++)
+        {
+            stype s = order[k];
+
+            if (k == row_start[i] or targets[s] != targets[order[k - 1]])
+            {
+                e++;
+                indices[e] = targets[s];
+            }
+
+            weights[e] += unit_strength;
+            multiplicity[e]++;
+
+            if (with_distance)
+            {
+                mean_distance[e] += distances[s];
+            }
+        }
+    }
+
+    if (with_distance)
+    {
+        for (stype e = 0; e < num_edges; e++)
+        {
+            mean_distance[e] /= multiplicity[e];
+        }
     }
 }
 
@@ -1051,4 +1390,12 @@ void test_random_generator_(Random_vecs &values, stype size)
     printf("%lu number generated from rng\n", values[0].size());
 }
 
+
+double test_unstuck_angle_(double x, double y, double current_angle,
+                           double radius, const std::string &area)
+{
+    return kernel().space_manager.unstuck_angle(BPoint(x, y), current_angle,
+                                                radius, area, 0);
+}
+
 } // namespace growth
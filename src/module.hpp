@@ -65,8 +65,8 @@ stype create_objects_(const std::string &object_name,
 
 
 stype create_neurons_(
-    const std::vector<statusMap> &neuron_params,
-    const std::unordered_map<std::string, std::vector<statusMap>> &neurite_params);
+    const StatusTable &neuron_params,
+    const std::unordered_map<std::string, StatusTable> &neurite_params);
 
 
 void create_neurites_(
@@ -95,13 +95,14 @@ void set_environment_(
     const std::vector<std::unordered_map<std::string, double>> &properties);
 
 
-void set_status_(stype gid, statusMap status,
-                 std::unordered_map<std::string, statusMap> neurite_statuses);
+void set_status_(
+    stype gid, const statusMap &status,
+    const std::unordered_map<std::string, statusMap> &neurite_statuses);
 
 
-void set_status_(std::vector<stype> gids, std::vector<statusMap> status,
-                 std::unordered_map<std::string, std::vector<statusMap>>
-                     neurite_statuses);
+void set_status_(
+    const std::vector<stype> &gids, const StatusTable &status,
+    const std::unordered_map<std::string, StatusTable> &neurite_statuses);
 
 
 void set_neurite_status_(stype neuron, std::string neurite, statusMap status);
@@ -115,6 +116,10 @@ void simulate_(const Time &simtime);
 void test_random_generator_(Random_vecs &values, stype size);
 
 
+double test_unstuck_angle_(double x, double y, double current_angle,
+                           double radius, const std::string &area);
+
+
 /* Getters functions */
 
 void get_environment_(
@@ -198,9 +203,9 @@ void get_geom_skeleton_(std::vector<stype> gids,
 
 void generate_synapses_(
     bool crossings_only, double density, bool only_new_syn,
-    bool autapse_allowed, const std::set<stype> &presyn_pop,
-    const std::set<stype> &postsyn_pop, std::vector<stype> &presyn_neurons,
-    std::vector<stype> &postsyn_neurons,
+    bool autapse_allowed, bool deterministic,
+    const std::set<stype> &presyn_pop, const std::set<stype> &postsyn_pop,
+    std::vector<stype> &presyn_neurons, std::vector<stype> &postsyn_neurons,
     std::vector<std::string> &presyn_neurites,
     std::vector<std::string> &postsyn_neurites,
     std::vector<stype> &presyn_nodes, std::vector<stype> &postsyn_nodes,
@@ -209,6 +214,55 @@ void generate_synapses_(
     std::vector<double> &post_syn_x, std::vector<double> &post_syn_y);
 
 
+void get_contacts_(
+    double max_distance, bool autapse_allowed,
+    const std::set<stype> &presyn_pop, const std::set<stype> &postsyn_pop,
+    std::vector<stype> &presyn_neurons, std::vector<stype> &postsyn_neurons,
+    std::vector<std::string> &presyn_neurites,
+    std::vector<std::string> &postsyn_neurites,
+    std::vector<stype> &presyn_nodes, std::vector<stype> &postsyn_nodes,
+    std::vector<stype> &presyn_segments, std::vector<stype> &postsyn_segments,
+    std::vector<double> &contact_area, std::vector<double> &contact_x,
+    std::vector<double> &contact_y, std::vector<double> &soma_distance);
+
+
+void get_contact_log_(
+    bool only_new, std::vector<stype> &presyn_neurons,
+    std::vector<stype> &postsyn_neurons,
+    std::vector<std::string> &presyn_neurites,
+    std::vector<std::string> &postsyn_neurites,
+    std::vector<stype> &presyn_nodes, std::vector<stype> &postsyn_nodes,
+    std::vector<stype> &presyn_segments, std::vector<stype> &postsyn_segments,
+    std::vector<double> &contact_area, std::vector<double> &contact_x,
+    std::vector<double> &contact_y, std::vector<double> &contact_time,
+    std::vector<double> &soma_distance);
+
+
+void get_overlaps_(
+    double max_distance, const std::vector<stype> &overlaps,
+    const std::vector<stype> &presyn_neurons,
+    const std::vector<stype> &postsyn_neurons,
+    const std::vector<std::string> &presyn_neurites,
+    const std::vector<std::string> &postsyn_neurites,
+    const std::vector<stype> &presyn_nodes,
+    const std::vector<stype> &postsyn_nodes,
+    const std::vector<stype> &presyn_segments,
+    const std::vector<stype> &postsyn_segments,
+    std::vector<double> &overlap_area, std::vector<double> &overlap_x,
+    std::vector<double> &overlap_y, std::vector<double> &soma_distance);
+
+
+void aggregate_synapses_(const std::vector<stype> &nodes,
+                         const std::vector<stype> &presyn_neurons,
+                         const std::vector<stype> &postsyn_neurons,
+                         const std::vector<double> &distances,
+                         double unit_strength, std::vector<stype> &indptr,
+                         std::vector<stype> &indices,
+                         std::vector<double> &weights,
+                         std::vector<stype> &multiplicity,
+                         std::vector<double> &mean_distance);
+
+
 void get_distances_(stype gid, const std::string &neurite_name, stype node,
                     stype segment, double &dist_to_parent,
                     double &dist_to_soma);
@@ -125,6 +125,10 @@ def create_neurons(n=1, params=None, num_neurites=0, neurite_params=None,
     n : int, optional (default: 1)
     params : dict, optional (default: None)
         Parameters of the object (or shape object for obstacle).
+        Entries that differ between the neurons can be given as arrays
+        of size `n` (e.g. "position" as an (n, 2) array or "soma_radius");
+        floating point arrays are passed to the kernel as is, which
+        makes the creation of large populations fast.
     neurite_params : dict, optional (default: same as `params`)
         Specific parameters for neurite growth. Entries of the dict can
         be lists to give different parameters for the neurites of each
@@ -585,6 +589,10 @@ def delete_neurons(neurons=None):
     '''
     Delete neurons.
 
+    Their neurites are removed from space, so they no longer interact with
+    the remaining neurons, and their pending branching events are dropped.
+    Deleting many neurons at once is cheaper than one at a time.
+
     Parameters
     ----------
     neurons : list of neurons, optional (default: all neurons)
@@ -1257,7 +1265,9 @@ def get_recording(recorder, record_format="detailed"):
         if record_format == "detailed":
             if "data" in recording[observable]:
                 recording[observable]["data"].update(rec_tmp[observable])
-                recording[observable]["times"].update(rec_tmp["times"])
+                # continuous recorders share the same times
+                if isinstance(rec_tmp["times"], dict):
+                    recording[observable]["times"].update(rec_tmp["times"])
             else:
                 recording[observable]["data"]  = rec_tmp[observable]
                 recording[observable]["times"] = rec_tmp["times"]
@@ -1425,18 +1435,49 @@ def set_kernel_status(status, value=None, simulation_id=None):
     * ``"adaptive_timestep"`` (float) - Value by which the step should be
       divided when growth cones are interacting. Set to -1 to disable adaptive
       timestep.
+    * ``"asynchronous_events"`` (bool) - Whether each thread processes the
+      branching events of its own neurons without waiting for the other
+      threads (default False). Threads then only synchronize at the end of
+      each step, when the positions of the neurites are shared, so neurites
+      see the growth of other threads' neurons with a delay of at most one
+      step.
+    * ``"compact_geometry"`` (bool) - Whether the points and the segment
+      polygons of the neurites created afterwards are stored in single
+      precision to save memory in very large cultures (default False). Each
+      point is then stored with an error smaller than 6e-8 times its distance
+      to the first point of its block of 64 points, and each polygon vertex
+      with an error smaller than 6e-8 times the segment size (less than
+      0.1 nm in practice). Polygons are rebuilt in double precision when they
+      are used, which makes interaction tests slightly slower.
+    * ``"distance_field_resolution"`` (length) - Grid step of the precomputed
+      distance to the walls of the environment (default 5 um).
     * ``"environment_required"`` (bool) - Whether a spatial environment should
       be provided or not.
+    * ``"growth_cone_tasks"`` (bool) - Whether the growth cones of large
+      neurites are grown as parallel tasks, which lets idle threads help
+      with neurons that have many growth cones (default False).
     * ``"interactions"`` (bool) - Whether neurites interact with one another.
+    * ``"load_balancing"`` (bool) - Whether neurons are moved between
+      threads during the simulation to balance the work (default False).
+      The work is measured from the time spent on each neuron, so results
+      are no longer reproducible when this is used with several threads.
+    * ``"load_balancing_interval"`` (int) - Number of steps between two
+      load balancings (default 50).
     * ``"max_allowed_resolution"`` (time) - Maximum timestep allowed.
     * ``"num_local_threads"`` (int) - the number of OpenMP thread per MPI
       process.
     * ``"print_time"`` (bool) - whether time should be printed
       during the simulation.
+    * ``"profiling"`` (bool) - whether timers and counters are collected
+      during the simulation (default False). They are aggregated at the end
+      of each call to :func:`~dense.simulate` and can be retrieved through
+      ``get_kernel_status("profile")``.
     * ``"resolution"`` (time) - the simulation timestep.
     * ``"seeds"`` (array) - array of seeds for the random number
       generators (one per processus, total number needs to be the
       same as `num_virtual_processes`)
+    * ``"track_contacts"`` (bool) - whether axon-dendrite contacts are
+      recorded as new segments are created (default False).
     '''
     if simulation_id is None:
         simulation_id = "defaultID"
@@ -1503,8 +1544,6 @@ def set_object_properties(objects, params=None, neurite_params=None):
 
         _check_params(params, object_name)
 
-        base_neuron_status = _get_scalar_status(params, n)
-
         if object_name == "neuron":
             def_model = params.get("growth_cone_model", "default")
 
@@ -1537,23 +1576,25 @@ def set_object_properties(objects, params=None, neurite_params=None):
                     base_neurite_statuses[_to_bytes(neurite)] = \
                         _get_scalar_status(status, n)
 
+    base_neuron_status = _get_scalar_status(params, n)
+
     cdef:
-        vector[statusMap] neuron_statuses = \
-            vector[statusMap](num_objects, base_neuron_status)
-        unordered_map[string, vector[statusMap]] neurite_statuses
+        StatusTable neuron_statuses = StatusTable(num_objects)
+        unordered_map[string, StatusTable] neurite_statuses
+
+    neuron_statuses.set_common(base_neuron_status)
 
     for neurite in neurite_params:
         bneurite = _to_bytes(neurite)
-        neurite_statuses[bneurite] = \
-            vector[statusMap](n, base_neurite_statuses[bneurite])
+        neurite_statuses[bneurite] = StatusTable(n)
+        neurite_statuses[bneurite].set_common(base_neurite_statuses[bneurite])
 
     # set the specific properties for each neurons
-    _set_vector_status(neuron_statuses, params)
+    _set_table_status(neuron_statuses, params)
 
-    # specific neurite parameters    
+    # specific neurite parameters
     for neurite, dic_params in neurite_params.items():
-        _set_vector_status(neurite_statuses[_to_bytes(neurite)],
-                           dic_params)
+        _set_table_status(neurite_statuses[_to_bytes(neurite)], dic_params)
 
     set_status_(gids, neuron_statuses, neurite_statuses)
 
@@ -1633,6 +1674,18 @@ def test_random_gen(size=10000):
     return c_values
 
 
+def _test_unstuck_angle(position, current_angle, radius,
+                        area="default_area"):
+    """
+    Angle widening returned by the kernel to unstuck a growth cone at
+    `position`, going in the direction `current_angle` (in radians), given
+    the walls of `area` and the neurites within `radius` (in micrometers).
+    """
+    x, y = position
+
+    return test_unstuck_angle_(x, y, current_angle, radius, _to_bytes(area))
+
+
 # --------------- #
 # Container tools #
 # --------------- #
@@ -1763,23 +1816,23 @@ cdef _create_neurons(dict params, dict neurite_params,
         base_neurite_statuses[_to_bytes(key)] = \
             _get_scalar_status(value, n)
 
-    # fill neuron_params with default statusMap (base_param)
+    # shared parameters are stored once, varying ones as columns
     cdef:
-        vector[statusMap] neuron_params = \
-            vector[statusMap](n, base_neuron_status)
-        unordered_map[string, vector[statusMap]] neurite_statuses
+        StatusTable neuron_params = StatusTable(n)
+        unordered_map[string, StatusTable] neurite_statuses
+
+    neuron_params.set_common(base_neuron_status)
 
     for neurite in neurite_params:
         bneurite = _to_bytes(neurite)
-        neurite_statuses[bneurite] = \
-            vector[statusMap](n, base_neurite_statuses[bneurite])
+        neurite_statuses[bneurite] = StatusTable(n)
+        neurite_statuses[bneurite].set_common(base_neurite_statuses[bneurite])
 
     # set the specific properties for each neurons
-    _set_vector_status(neuron_params, params)
-    # specific neurite parameters    
+    _set_table_status(neuron_params, params)
+    # specific neurite parameters
     for neurite, dic_params in neurite_params.items():
-        _set_vector_status(neurite_statuses[_to_bytes(neurite)],
-                           dic_params)
+        _set_table_status(neurite_statuses[_to_bytes(neurite)], dic_params)
 
     # create neurons
     i = create_neurons_(neuron_params, neurite_statuses)
@@ -1959,9 +2012,13 @@ def _get_geom_skeleton(gid):
 
 
 def _generate_synapses(bool crossings_only, double density, bool only_new_syn,
-                       bool autapse_allowed, source_neurons, target_neurons):
+                       bool autapse_allowed, source_neurons, target_neurons,
+                       bool deterministic=False):
     '''
     Generate the synapses from the neurons' morphologies.
+
+    If `deterministic` is True, the synapses are returned in the same order
+    and with the same random draws whatever the number of threads.
     '''
     cdef:
         vector[stype] presyn_neurons, postsyn_neurons
@@ -1973,10 +2030,11 @@ def _generate_synapses(bool crossings_only, double density, bool only_new_syn,
         cset[stype] postsyn_pop = target_neurons
 
     generate_synapses_(crossings_only, density, only_new_syn, autapse_allowed,
-                       presyn_pop, postsyn_pop, presyn_neurons, postsyn_neurons,
-                       presyn_neurites, postsyn_neurites, presyn_nodes,
-                       postsyn_nodes, presyn_segments, postsyn_segments,
-                       pre_syn_x, pre_syn_y, post_syn_x, post_syn_y)
+                       deterministic, presyn_pop, postsyn_pop, presyn_neurons,
+                       postsyn_neurons, presyn_neurites, postsyn_neurites,
+                       presyn_nodes, postsyn_nodes, presyn_segments,
+                       postsyn_segments, pre_syn_x, pre_syn_y, post_syn_x,
+                       post_syn_y)
 
     data = {
         "source_neuron": presyn_neurons,
@@ -1996,6 +2054,176 @@ def _generate_synapses(bool crossings_only, double density, bool only_new_syn,
     return data
 
 
+def _get_contacts(source_neurons, target_neurons, double max_distance=0.,
+                  bool autapse_allowed=False):
+    '''
+    Get all contacts between the axons of `source_neurons` and the dendrites
+    or somas of `target_neurons`.
+
+    Segments are in contact if they overlap after being dilated by half of
+    `max_distance` (in micrometers).
+
+    Returns a dictionary of arrays describing each contact: source and
+    target neuron, neurite, node, and segment, "area" of the overlap,
+    position ("pos_x", "pos_y"), and "distance" (soma-to-contact-to-soma).
+    '''
+    cdef:
+        vector[stype] presyn_neurons, postsyn_neurons
+        vector[string] presyn_neurites, postsyn_neurites
+        vector[stype] presyn_nodes, postsyn_nodes
+        vector[stype] presyn_segments, postsyn_segments
+        vector[double] contact_area, contact_x, contact_y, soma_distance
+        cset[stype] presyn_pop  = source_neurons
+        cset[stype] postsyn_pop = target_neurons
+
+    get_contacts_(max_distance, autapse_allowed, presyn_pop, postsyn_pop,
+                  presyn_neurons, postsyn_neurons, presyn_neurites,
+                  postsyn_neurites, presyn_nodes, postsyn_nodes,
+                  presyn_segments, postsyn_segments, contact_area, contact_x,
+                  contact_y, soma_distance)
+
+    data = {
+        "source_neuron": np.asarray(presyn_neurons, dtype=int),
+        "target_neuron": np.asarray(postsyn_neurons, dtype=int),
+        "source_neurite": [_to_string(n) for n in presyn_neurites],
+        "target_neurite": [_to_string(n) for n in postsyn_neurites],
+        "source_node": np.asarray(presyn_nodes, dtype=int),
+        "target_node": np.asarray(postsyn_nodes, dtype=int),
+        "source_segment": np.asarray(presyn_segments, dtype=int),
+        "target_segment": np.asarray(postsyn_segments, dtype=int),
+        "area": np.asarray(contact_area),
+        "pos_x": np.asarray(contact_x),
+        "pos_y": np.asarray(contact_y),
+        "distance": np.asarray(soma_distance),
+    }
+
+    return data
+
+
+def _get_contact_log(bool only_new=False):
+    '''
+    Get the contacts recorded during growth when the "track_contacts" kernel
+    property is True.
+
+    If `only_new` is True, only the contacts detected since the previous call
+    are returned.
+    Contacts of segments which were retracted or deleted are removed from the
+    log and each pair of segments is logged only once.
+    The dictionary contains the same entries as :func:`_get_contacts` plus
+    the "time" (in minutes) at which each contact appeared.
+    '''
+    cdef:
+        vector[stype] presyn_neurons, postsyn_neurons
+        vector[string] presyn_neurites, postsyn_neurites
+        vector[stype] presyn_nodes, postsyn_nodes
+        vector[stype] presyn_segments, postsyn_segments
+        vector[double] contact_area, contact_x, contact_y, contact_time
+        vector[double] soma_distance
+
+    get_contact_log_(only_new, presyn_neurons, postsyn_neurons,
+                     presyn_neurites, postsyn_neurites, presyn_nodes,
+                     postsyn_nodes, presyn_segments, postsyn_segments,
+                     contact_area, contact_x, contact_y, contact_time,
+                     soma_distance)
+
+    data = {
+        "source_neuron": np.asarray(presyn_neurons, dtype=int),
+        "target_neuron": np.asarray(postsyn_neurons, dtype=int),
+        "source_neurite": [_to_string(n) for n in presyn_neurites],
+        "target_neurite": [_to_string(n) for n in postsyn_neurites],
+        "source_node": np.asarray(presyn_nodes, dtype=int),
+        "target_node": np.asarray(postsyn_nodes, dtype=int),
+        "source_segment": np.asarray(presyn_segments, dtype=int),
+        "target_segment": np.asarray(postsyn_segments, dtype=int),
+        "area": np.asarray(contact_area),
+        "pos_x": np.asarray(contact_x),
+        "pos_y": np.asarray(contact_y),
+        "time": np.asarray(contact_time),
+        "distance": np.asarray(soma_distance),
+    }
+
+    return data
+
+
+def _get_overlaps(contacts, overlaps, double max_distance=0.):
+    '''
+    Get the geometry of overlaps made of several `contacts` (as returned by
+    :func:`_get_contacts`), `overlaps` giving the label (from 0 to the number
+    of overlaps minus one) of the overlap each contact belongs to.
+
+    The overlap is the intersection of the union of its presynaptic segments
+    with the union of its postsynaptic segments, after they were dilated by
+    half of `max_distance`, so that the area shared by several contacts is
+    counted only once.
+
+    Returns a dictionary with the "area", position ("pos_x", "pos_y"), and
+    "distance" (soma-to-overlap-to-soma) of each overlap.
+    '''
+    cdef:
+        vector[stype] coverlaps = overlaps
+        vector[stype] presyn_neurons = contacts["source_neuron"]
+        vector[stype] postsyn_neurons = contacts["target_neuron"]
+        vector[string] presyn_neurites, postsyn_neurites
+        vector[stype] presyn_nodes = contacts["source_node"]
+        vector[stype] postsyn_nodes = contacts["target_node"]
+        vector[stype] presyn_segments = contacts["source_segment"]
+        vector[stype] postsyn_segments = contacts["target_segment"]
+        vector[double] overlap_area, overlap_x, overlap_y, soma_distance
+
+    presyn_neurites  = [_to_bytes(n) for n in contacts["source_neurite"]]
+    postsyn_neurites = [_to_bytes(n) for n in contacts["target_neurite"]]
+
+    get_overlaps_(max_distance, coverlaps, presyn_neurons, postsyn_neurons,
+                  presyn_neurites, postsyn_neurites, presyn_nodes,
+                  postsyn_nodes, presyn_segments, postsyn_segments,
+                  overlap_area, overlap_x, overlap_y, soma_distance)
+
+    data = {
+        "area": np.asarray(overlap_area),
+        "pos_x": np.asarray(overlap_x),
+        "pos_y": np.asarray(overlap_y),
+        "distance": np.asarray(soma_distance),
+    }
+
+    return data
+
+
+def _aggregate_synapses(nodes, sources, targets, distances=None,
+                        double unit_strength=1.):
+    '''
+    Merge the synapses from `sources` to `targets` into weighted edges.
+
+    Returns the CSR representation relative to `nodes` ("indptr" and
+    "indices"), as well as the "weight", "multiplicity" and average
+    "distance" (if `distances` is provided) of each edge.
+    '''
+    cdef:
+        vector[stype] cnodes = nodes
+        vector[stype] presyn = sources
+        vector[stype] postsyn = targets
+        vector[double] cdist
+        vector[stype] indptr, indices, multiplicity
+        vector[double] weights, mean_distance
+
+    if distances is not None:
+        cdist = distances
+
+    aggregate_synapses_(cnodes, presyn, postsyn, cdist, unit_strength, indptr,
+                        indices, weights, multiplicity, mean_distance)
+
+    data = {
+        "indptr": np.asarray(indptr, dtype=int),
+        "indices": np.asarray(indices, dtype=int),
+        "weight": np.asarray(weights),
+        "multiplicity": np.asarray(multiplicity, dtype=int),
+    }
+
+    if distances is not None:
+        data["distance"] = np.asarray(mean_distance)
+
+    return data
+
+
 def _get_parent_and_soma_distances(neuron, neurite, node, segment):
     '''
     Get the distance between a segment and its parent node as well as with the
@@ -2247,14 +2475,15 @@ cdef statusMap _get_scalar_status(dict params, int n) except *:
     return status
 
 
-cdef void _set_vector_status(vector[statusMap]& lst_statuses,
-                             dict params) except *:
+def _get_vector_values(dict params, stype n):
     '''
-    Parameter conversion for neuron and neurite parameters
+    Parameter conversion for neuron and neurite parameters which vary between
+    the objects: return a dict containing, for each key, the list of the `n`
+    converted values.
     '''
-    cdef:
-        stype n = lst_statuses.size()
-        stype len_val, len_v, i
+    cdef stype len_val, len_v, i
+
+    values = {}
 
     for key, val in params.items():
         key = _to_bytes(key)
@@ -2267,9 +2496,8 @@ cdef void _set_vector_status(vector[statusMap]& lst_statuses,
 
                 assert val.shape == (n, 2), "Positions array must be of " +\
                                             "shape (N, 2)."
-                for i in range(n):
-                    lst_statuses[i][b"x"] = _to_property("x", val[i][0])
-                    lst_statuses[i][b"y"] = _to_property("y", val[i][1])
+                values[b"x"] = val[:, 0]
+                values[b"y"] = val[:, 1]
         elif isinstance(val, dict):
             if not is_scalar(next(iter(val))):
                 for k, v in val.items():
@@ -2281,9 +2509,9 @@ cdef void _set_vector_status(vector[statusMap]& lst_statuses,
                 for k, v in val.items():
                     new_val[k] = to_cppunit(v, k)
                 di_keys = list(new_val.keys())
-                for i in range(n):
-                    new_dict = {k: new_val[k][i] for k in di_keys}
-                    lst_statuses[i][key] = _to_property(key, new_dict)
+                values[key] = [
+                    {k: new_val[k][i] for k in di_keys} for i in range(n)
+                ]
         elif not is_scalar(val) and not isinstance(val, set):
             # set is for scalar neurite names
             len_val = len(val)
@@ -2294,8 +2522,53 @@ cdef void _set_vector_status(vector[statusMap]& lst_statuses,
                     val[i] = {k: to_cppunit(v, k) for k, v in dic.items()}
             else:
                 val = to_cppunit(val, key)
-            for i, v in enumerate(val):
-                lst_statuses[i][key] = _to_property(key, v)
+            values[key] = val
+
+    return values
+
+
+cdef void _set_vector_status(vector[statusMap]& lst_statuses,
+                             dict params) except *:
+    '''
+    Parameter conversion for neuron and neurite parameters
+    '''
+    cdef stype i
+
+    for key, val in _get_vector_values(params, lst_statuses.size()).items():
+        for i, v in enumerate(val):
+            lst_statuses[i][key] = _to_property(key, v)
+
+
+cdef void _set_table_status(StatusTable& table, dict params) except *:
+    '''
+    Store the varying neuron and neurite parameters as columns of `table`.
+
+    Floating point arrays (e.g. positions or soma radii) are copied directly
+    into columns of doubles, other values are converted one by one.
+    '''
+    cdef:
+        vector[Property] column
+        vector[double] dcolumn
+        double[::1] darray
+        stype i
+
+    for key, val in _get_vector_values(params, table.size()).items():
+        if isinstance(val, np.ndarray) and val.dtype.kind == "f":
+            darray = np.ascontiguousarray(val, dtype=float)
+            dcolumn.resize(darray.shape[0])
+
+            for i in range(darray.shape[0]):
+                dcolumn[i] = darray[i]
+
+            table.set_double_column(key, dcolumn)
+            continue
+
+        column.clear()
+
+        for v in val:
+            column.push_back(_to_property(key, v))
+
+        table.set_column(key, column)
 
 
 def _get_recorder_data(gid, recording, rec_status, time_units):
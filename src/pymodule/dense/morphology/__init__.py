@@ -25,11 +25,13 @@
 from . import algorithms
 
 from .algorithms import tree_asymmetry
-from .connections import generate_network, get_connections
+from .connections import (aggregate_connections, generate_network,
+                          get_connections)
 from .graph import SpatialNetwork, SpatialMultiNetwork
 from .neuron_shape import NeuronStructure
 
 __all__ = [
+    "aggregate_connections",
     "algorithms",
     "generate_network",
     "get_connections",
@@ -25,7 +25,6 @@
 from collections import defaultdict, OrderedDict
 
 import numpy as np
-from shapely.geometry import MultiPolygon
 
 from .. import _pygrowth as _pg
 from ..elements import Population
@@ -34,6 +33,7 @@ from .graph import SpatialMultiNetwork, SpatialNetwork
 
 
 __all__ = [
+    "aggregate_connections",
     "generate_network",
     "get_connections",
 ]
@@ -157,7 +157,7 @@ def generate_network(source_neurons=None, target_neurons=None,
 
     shape = _pg.get_environment()
     unit = "micrometer" if shape is None else shape.unit
-    positions     = np.array(
+    node_positions = np.array(
         [neuron.position.to(unit).magnitude for neuron in population])
 
     # test if there is a network to create
@@ -166,15 +166,29 @@ def generate_network(source_neurons=None, target_neurons=None,
                            'or environment.')
 
     network = NetClass(population=population, shape=shape,
-                       positions=positions, multigraph=multigraph)
+                       positions=node_positions, multigraph=multigraph)
 
-    num_synapses = len(edges)
+    if not multigraph:
+        # merge the synapses into equivalent connections natively
+        csr = aggregate_connections(
+            edges, distances=distances, nodes=[int(n) for n in population],
+            unit_strength=default_synaptic_strength)
+
+        data = {}
+
+        if distances is not None:
+            data["distance"] = csr["distance"]
+
+        network.new_aggregated_edges(csr["edges"], csr["weight"],
+                                     csr["multiplicity"], attributes=data)
+
+        return network
 
     # edge data
     data = {}
 
     # for multigraphs we keep the positions as valid attributes
-    if multigraph and positions is not None:
+    if positions is not None:
         data["synapse_position"] = np.array(positions)
     
     if distances is not None:
@@ -186,10 +200,55 @@ def generate_network(source_neurons=None, target_neurons=None,
     return network
 
 
+def aggregate_connections(edges, distances=None, nodes=None,
+                          unit_strength=1.):
+    '''
+    Merge the synapses between each pair of neurons into one equivalent
+    connection.
+
+    Parameters
+    ----------
+    edges : list of 2-tuples or array of shape (num_synapses, 2)
+        Synapses (source, target), as returned by
+        :func:`~dense.morphology.get_connections`.
+    distances : array of length `num_synapses`, optional (default: None)
+        Distance associated to each synapse.
+    nodes : list of ints, optional (default: neurons in `edges`)
+        Neurons of the network (order of the CSR rows and columns).
+    unit_strength : float, optional (default: 1.)
+        Strength of a single synapse.
+
+    Returns
+    -------
+    csr : dict
+        Dictionary containing the "nodes", the CSR structure of the
+        connectivity ("indptr" and "indices", sorted by source then target),
+        the corresponding "edges" array of shape (num_edges, 2), and the
+        "weight", "multiplicity" and average "distance" of each edge.
+    '''
+    edges = np.asarray(edges, dtype=int).reshape(-1, 2)
+
+    if nodes is None:
+        nodes = np.unique(edges)
+
+    nodes = np.asarray(nodes, dtype=int)
+
+    csr = _pg._aggregate_synapses(nodes, edges[:, 0], edges[:, 1],
+                                  distances, unit_strength)
+
+    sources = np.repeat(nodes, np.diff(csr["indptr"]))
+    targets = nodes[csr["indices"]]
+
+    csr["nodes"] = nodes
+    csr["edges"] = np.array([sources, targets], dtype=int).T
+
+    return csr
+
+
 def get_connections(source_neurons=None, target_neurons=None,
                     method="intersections", spine_density=0.5/(um**2),
-                    connection_probability=0.2, autapse_allowed=False,
-                    **kwargs):
+                    connection_probability=0.2, only_new_connections=False,
+                    autapse_allowed=False, **kwargs):
     """
     Obtain connection between `source_neurons` and `target_neurons` through
     a given method for synapse generation.
@@ -236,6 +295,9 @@ def get_connections(source_neurons=None, target_neurons=None,
         If true, only the potential synapses that have been found during the
         last simulation run will be used; otherwise, all potential sites found
         since time 0 will be used.
+        Only used with the "intersections" `method` if the "track_contacts"
+        kernel property is True, in which case the contacts are read from the
+        log filled during growth instead of being recomputed.
     autapse_allowed : bool, optional (default: False)
         Whether connection from a neuron onto itself are generated if possible.
     **kwargs : optional arguments
@@ -275,27 +337,26 @@ def get_connections(source_neurons=None, target_neurons=None,
     if target_neurons is None:
         target_neurons = _pg.get_neurons(as_ints=True)
 
-    source_set  = set(source_neurons)
-    target_set  = set(target_neurons)
-    all_neurons = source_set.union(target_set)
-    
+    source_neurons = [int(n) for n in source_neurons]
+    target_neurons = [int(n) for n in target_neurons]
+
     edges, positions, distances = [], [], []
 
-    if all_neurons:
+    if source_neurons and target_neurons:
         syn_density = spine_density.m_as("1 / micrometer**2")
+        max_dist    = 0. if crossings_only else max_spine_length
 
-        axons, dendrites, somas = _pg._get_geom_skeleton(all_neurons)
-
-        soma_pos = np.array(somas)[:2, :].T
-
-        if crossings_only:
-            edges, positions, distances = _edges_from_intersections(
-                source_set, target_set, axons, dendrites, soma_pos, syn_density,
-                connection_probability, autapse_allowed)
+        if crossings_only and _pg.get_kernel_status("track_contacts"):
+            contacts = _filter_contacts(
+                _pg._get_contact_log(only_new_connections), source_neurons,
+                target_neurons, autapse_allowed)
         else:
-            edges, positions, distances = _edges_from_spines(
-                source_set, target_set, axons, dendrites, soma_pos, syn_density,
-                connection_probability, autapse_allowed, max_spine_length)
+            contacts = _pg._get_contacts(source_neurons, target_neurons,
+                                         max_dist, autapse_allowed)
+
+        edges, positions, distances = _edges_from_contacts(
+            _merge_contacts(contacts, max_dist), syn_density,
+            connection_probability)
 
     return edges, positions, distances
 
@@ -304,122 +365,93 @@ def get_connections(source_neurons=None, target_neurons=None,
 # Python-level synapse formation #
 # ------------------------------ #
 
-def _get_synapses_intersection(axon_polygon, d_polygon, synapse_density, somas,
-                               connection_probability, etuple, i, j, edges,
-                               positions, distances):
+def _filter_contacts(contacts, source_neurons, target_neurons,
+                     autapse_allowed):
     '''
-    Tool fuction to find synapses of intersecting neurites
+    Keep only the contacts from `source_neurons` to `target_neurons`.
     '''
-    intsct = axon_polygon.intersection(d_polygon)
+    keep = np.isin(contacts["source_neuron"], source_neurons) \
+           & np.isin(contacts["target_neuron"], target_neurons)
 
-    if not isinstance(intsct, MultiPolygon):
-        intsct = [intsct]
-    
-    for poly in intsct:
-        total        = poly.area * synapse_density * connection_probability
-        rnd          = np.random.random()
-        num_synapses = int(total) + (1 if (total - int(total)) < rnd else 0)
-
-        if num_synapses > 0:
-            s_soma = np.array(somas[i])
-            t_soma = np.array(somas[j])
-            pos    = poly.centroid
-            dist   = np.linalg.norm(s_soma - pos) \
-                    + np.linalg.norm(t_soma - pos)
-
-            positions.extend([pos]*num_synapses)
-            edges.extend([etuple]*num_synapses)
-            distances.extend([dist]*num_synapses)
-
-
-def _edges_from_intersections(source_set, target_set, axons, dendrites,
-                              somas, synapse_density, connection_probability,
-                              autapse_allowed):
-    """
-    Obtain synapses with a simple approach based only on neurite intersections.
-    """
-    edges, positions, distances = [], [], []
+    if not autapse_allowed:
+        keep &= contacts["source_neuron"] != contacts["target_neuron"]
 
-    for i, (axon_gid, axon_polygon) in enumerate(axons.items()):
-        if axon_gid in source_set:
-            for j, (dend_gid, vd) in enumerate(dendrites.items()):
-                connection_allowed = (dend_gid != axon_gid or autapse_allowed)
+    return {k: np.asarray(v)[keep] for k, v in contacts.items()}
 
-                if dend_gid in target_set and connection_allowed:
-                    etuple = (axon_gid, dend_gid)
-                    for d_polygon in vd:
-                        if axon_polygon.intersects(d_polygon):
-                            _get_synapses_intersection(
-                                axon_polygon, d_polygon, synapse_density,
-                                somas, connection_probability, etuple, i, j, 
-                                edges, positions, distances)
 
-    return edges, positions, distances
+def _merge_contacts(contacts, max_distance=0.):
+    '''
+    Merge the contacts between segments into one contact per connected
+    overlap of an axon and a dendrite (or soma).
 
+    Two segment contacts of the same pair of neurites belong to the same
+    overlap when they share a segment. The area, position and distance of
+    the merged contact are computed on the union of its segments (dilated by
+    half of `max_distance`), since neighboring segments overlap.
+    '''
+    num_contacts = len(contacts["area"])
 
-def _edges_from_spines(source_set, target_set, axons, dendrites, somas,
-                       synapse_density, connection_probability, autapse_allowed,
-                       max_spine_length):
-    """
-    Create synapses based on distance and spine density.
-    """
-    edges, positions, distances = [], [], []
+    if num_contacts == 0:
+        return contacts
+
+    neurites = np.unique(
+        list(contacts["source_neurite"]) + list(contacts["target_neurite"]),
+        return_inverse=True)[1]
+
+    pairs = np.unique(
+        np.array([contacts["source_neuron"], neurites[:num_contacts],
+                  contacts["target_neuron"], neurites[num_contacts:]]).T,
+        axis=0, return_inverse=True)[1].ravel()
+
+    # segments of each side, specific to the neurite pair
+    sides = [
+        np.unique(np.array([pairs, contacts[side + "_node"],
+                            contacts[side + "_segment"]]).T,
+                  axis=0, return_inverse=True)[1].ravel()
+        for side in ("source", "target")
+    ]
+
+    # propagate the smallest contact index through the shared segments
+    labels  = np.arange(num_contacts)
+    changed = True
 
-    # save dendrites buffers
-    buffers = {}
-
-    for i, (axon_gid, axon_polygon) in enumerate(axons.items()):
-        if axon_gid in source_set:
-            axon_polygon = axon_polygon.buffer(max_spine_length)
-            for j, (dend_gid, vd) in enumerate(dendrites.items()):
-                connection_allowed = (dend_gid != axon_gid or autapse_allowed)
-
-                if dend_gid in target_set and connection_allowed:
-                    etuple = (axon_gid, dend_gid)
-                    for k, d_polygon in enumerate(vd):
-                        if axon_polygon.intersects(d_polygon):
-                            _get_synapses_intersection(
-                                axon_polygon, d_polygon, synapse_density, somas,
-                                connection_probability, etuple, i, j, edges,
-                                positions, distances)
-                        else:
-                            # buffer the neurite to get intersections with
-                            # extending spines
-                            d_buffer = None
-                            d_tuple  = (j, k)
-
-                            if d_tuple not in buffers:
-                                d_buffer   = d_polygon.buffer(max_spine_length)
-                                buffers[d_tuple] = d_buffer
-                            else:
-                                d_buffer = buffers[d_tuple]
-
-                            if axon_polygon.intersects(d_buffer):
-                                # we use a linear spine density of an area
-                                # 1 micron thick along the intersected line
-                                # i.e. linear density has same magnitude as
-                                # areal density
-                                insct_line = \
-                                    axon_polygon.intersection(d_buffer.exterior)
-                                
-                                # then compute the number of synapses
-                                total   = insct_line.length * synapse_density \
-                                          * connection_probability
-                                rnd     = np.random.random()
-                                num_syn = int(total) + \
-                                          (1 if (total - int(total)) < rnd
-                                           else 0)
-
-                                if num_syn > 0:
-                                    s_soma = np.array(somas[i])
-                                    t_soma = np.array(somas[j])
-                                    pos    = insct_line.centroid
-                                    dist   = np.linalg.norm(s_soma - pos) \
-                                            + np.linalg.norm(t_soma - pos)
-
-                                    positions.extend([pos]*num_syn)
-                                    edges.extend([etuple]*num_syn)
-                                    distances.extend([dist]*num_syn)
+    while changed:
+        old_labels = labels.copy()
+
+        for segments in sides:
+            smallest = np.full(segments.max() + 1, num_contacts)
+            np.minimum.at(smallest, segments, labels)
+            labels = smallest[segments]
+
+        changed = not np.array_equal(labels, old_labels)
+
+    first, overlap = np.unique(labels, return_index=True,
+                               return_inverse=True)[1:]
+
+    merged = _pg._get_overlaps(contacts, overlap.ravel(), max_distance)
+
+    for k in ("source_neuron", "target_neuron"):
+        merged[k] = np.asarray(contacts[k])[first]
+
+    return merged
+
+
+def _edges_from_contacts(contacts, synapse_density, connection_probability):
+    '''
+    Draw the synapses from the native contact table, each contact giving
+    :math:`\\rho_s A_I p_c` synapses on average.
+    '''
+    total   = contacts["area"] * synapse_density * connection_probability
+    num_syn = np.floor(total).astype(int)
+    num_syn += (np.random.random(len(total)) < total - num_syn)
+
+    pre  = np.repeat(contacts["source_neuron"], num_syn)
+    post = np.repeat(contacts["target_neuron"], num_syn)
+
+    edges     = list(zip(pre, post))
+    positions = np.repeat(
+        np.array([contacts["pos_x"], contacts["pos_y"]]).T, num_syn, axis=0)
+    distances = np.repeat(contacts["distance"], num_syn)
 
     return edges, positions, distances
 
@@ -497,7 +529,7 @@ def _generate_network_future(source_neurons=None, target_neurons=None,
         target_neurons = _pg.get_neurons(as_ints=True)
 
     if data is None:
-        data = get_connections(
+        data = _get_connections_future(
             source_neurons=source_neurons, target_neurons=target_neurons,
             method=method, spine_density=spine_density,
             only_new_connections=only_new_connections,
@@ -515,10 +547,11 @@ def _generate_network_future(source_neurons=None, target_neurons=None,
 
     shape = _pg.get_environment()
     unit = "micrometer" if shape is None else shape.unit
-    positions     = np.array(
+    node_positions = np.array(
         [neuron.position.to(unit).magnitude for neuron in population])
 
-    network = NetClass(population=population, shape=shape, positions=positions)
+    network = NetClass(population=population, shape=shape,
+                       positions=node_positions, multigraph=multigraph)
 
     # prepare the edges
     elist = np.array([data["source_neuron"], data["target_neuron"]], dtype=int)
@@ -593,7 +626,7 @@ def _generate_network_future(source_neurons=None, target_neurons=None,
 def _get_connections_future(source_neurons=None, target_neurons=None,
                     method="intersections", spine_density=0.5/(um**2),
                     only_new_connections=False, autapse_allowed=False,
-                    **kwargs):
+                    deterministic=False, **kwargs):
     """
     Obtain connection between `source_neurons` and `target_neurons` through
     a given method for synapse generation.
@@ -625,6 +658,9 @@ def _get_connections_future(source_neurons=None, target_neurons=None,
         since time 0 will be used.
     autapse_allowed : bool, optional (default: False)
         Whether connection from a neuron onto itself are generated if possible.
+    deterministic : bool, optional (default: False)
+        Whether the synapses should be generated in an order (and with random
+        draws) that does not depend on the number of threads.
 
     Returns
     -------
@@ -654,4 +690,4 @@ def _get_connections_future(source_neurons=None, target_neurons=None,
 
     return _pg._generate_synapses(
         crossings_only, density, only_new_connections, autapse_allowed,
-        source_neurons, target_neurons)
+        source_neurons, target_neurons, deterministic)
@@ -653,3 +653,52 @@ class SpatialNetwork(_BaseNetwork):
             final_elist = list(edges.keys())
 
             super(SpatialNetwork, self).new_edges(final_elist, final_attrs)
+
+    def new_aggregated_edges(self, edge_list, weights, multiplicity,
+                             attributes=None):
+        '''
+        Add edges which were already merged (e.g. through
+        :func:`~dense.morphology.aggregate_connections`) in bulk.
+
+        Parameters
+        ----------
+        edge_list : np.array of shape (edge_nb, 2)
+            Unique edges (source, target), none of which should already exist
+            in the network.
+        weights : array of length edge_nb
+            Equivalent strength of each edge.
+        multiplicity : array of length edge_nb
+            Number of synapses merged into each edge.
+        attributes : :class:`dict`, optional (default: ``{}``)
+            Other edge properties (averaged over the merged synapses).
+        '''
+        attributes = {} if attributes is None else dict(attributes)
+        edge_list  = np.asarray(edge_list, dtype=int).reshape(-1, 2)
+
+        assert self.edge_nb() == 0, \
+            "Aggregated edges can only be added to an empty network."
+
+        if self.is_weighted():
+            attributes["weight"] = np.asarray(weights)
+
+        if _with_nngt:
+            attributes["multiplicity"] = np.asarray(multiplicity, dtype=int)
+
+            super(SpatialNetwork, self).new_edges(edge_list, attributes)
+        else:
+            num_edges = len(edge_list)
+
+            self._edges.update(
+                zip(map(tuple, edge_list.tolist()),
+                    ({i} for i in range(num_edges))))
+
+            self._edge_nb = num_edges
+
+            for k, v in attributes.items():
+                if k == "weight":
+                    self._weights.extend(v)
+                else:
+                    assert k in self._attributes, \
+                        "`" + k + "` is not a valid synaptic attribute."
+
+                    self._attributes[k].extend(v)
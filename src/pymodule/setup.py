@@ -0,0 +1,172 @@
+# -*- coding: utf-8 -*-
+#
+# setup.py
+#
+# This file is part of DeNSE.
+#
+# Copyright (C) 2019 SeNEC Initiative
+#
+# DeNSE is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# DeNSE is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with DeNSE. If not, see <http://www.gnu.org/licenses/>.
+
+import os
+import platform
+import sysconfig
+from distutils.command.build_ext import build_ext
+from setuptools import setup, Extension
+try:
+    from setuptools import find_namespace_packages as getpackages
+except ImportError:
+    from setuptools import find_packages as getpackages
+
+import numpy as np
+
+try:
+    from Cython.Build import cythonize
+    import setuptools
+    version = setuptools.__version__
+    version = int(version[:version.index(".")])
+    with_cython = True if version >= 18 else False
+    from _cpp_header import clean_cpp
+    with_cython = True
+except ImportError:
+    with_cython = False
+
+
+# ------------------- #
+# Multiplatform flags #
+# ------------------- #
+
+# compiler options
+
+copt =  {
+    'msvc': [
+        '/openmp', '/Od', '/fp:precise', '/permissive-', '/Zc:twoPhase-',
+        '/MDd' if "Release" == "Debug" else "/MD", "-Zi", "/Ox",
+        '/D_ITERATOR_DEBUG_LEVEL=2' if "Release" == "Debug" else "",
+    ],
+    'unix': [
+        '-std=c++11', '-Wno-cpp', '-Wno-unused-function', '-fopenmp',
+        '-ffast-math', '-msse', '-ftree-vectorize', '-O2', '-g', "-fPIC",
+    ],
+}
+
+lopt =  {
+    'unix': ['-fopenmp'],
+	'msvc': ['/subsystem:windows', "/debug"],
+}
+
+# custom class
+
+class CustomBuildExt(build_ext):
+
+    def build_extensions(self):
+        # find environment variable for compiler
+        c = os.environ.get('CXX', None)
+        # or configuration
+        if c is None:
+            c = sysconfig.get_config_var('CXX')
+        # or default value
+        if c is None:
+            from distutils import ccompiler
+            c = ccompiler.get_default_compiler()
+        # normalize names
+        c = "msvc" if "msvc" in c else "unix"
+
+        try:
+            self.compiler.compiler_so.remove("-Wstrict-prototypes")
+        except:
+            pass
+        try:
+            self.compiler.compiler_so.remove("-O3")
+        except:
+            pass
+
+        for e in self.extensions:
+            e.extra_link_args.extend(lopt.get(c, []))
+            e.extra_compile_args.extend(copt.get(c, []))
+
+        # mac fix from https://stackoverflow.com/a/19147134
+        if platform.system() == 'Darwin':
+            for e in self.extensions:
+                e.extra_link_args.append('-Wl,-rpath,/tmp/dinstall/lib')
+
+        if not 0:
+            build_ext.build_extensions(self)
+
+
+# ------------------------------------- #
+# Extension to link C++ files to python #
+# ------------------------------------- #
+
+mod_name = "dense"
+
+ext = '.pyx' if with_cython else '.cpp'
+
+extensions = Extension(
+    mod_name + "._pygrowth", # name of extension
+    sources = [("" if 0 else '/root/repo/src/pymodule/') + mod_name + '/_pygrowth' + ext],
+    language = "c++",
+    include_dirs = [
+        '/root/repo/src',
+        '/root/repo/src/kernel',
+        '/root/repo/src/elements',
+        '/root/repo/src/libgrowth',
+        '/root/repo/src/spatial',
+        '/root/repo/src/pymodule/' + mod_name,
+		'/tmp/geos/include',
+        np.get_include()
+    ],
+    extra_compile_args = [],
+    extra_link_args = [],
+    libraries = ['cgrowth_py3.11'] + \
+                (['libgrowth_py3.11', 'kernel_py3.11',
+                  'elements_py3.11', 'spatial_py3.11']
+                  if 0 else []),
+    library_dirs = ['/tmp/dinstall/lib',],
+    runtime_library_dirs = [] if (0 or 0) else ['/tmp/dinstall/lib']
+)
+
+if with_cython:
+    extensions = cythonize(extensions, gdb_debug=(not 0))
+    clean_cpp('/root/repo/src/pymodule/' + mod_name + '/_pygrowth.cpp')
+else:
+    extensions = [extensions]
+
+
+# ----- #
+# Setup #
+# ----- #
+
+setup(
+    name = mod_name,
+    version = '0.1.0',
+    description = 'Package to study the growth of neuronal networks',
+    package_dir = {} if 0 else {'': '/root/repo/src/pymodule'},
+    packages = getpackages(
+        "." if 0 else '/root/repo/src/pymodule',
+        exclude=['dist', '_*', 'build', '*.egg-info']),
+
+    # Include the non python files (c++ library):
+    package_data = {mod_name: ['*.so', '*.dll', '*.a', '*.dylib', '*.pxd']},
+	include_package_data=False,
+
+    ext_modules = extensions,
+    cmdclass = {'build_ext': CustomBuildExt},
+
+    author = 'SENeC Initiative',
+    author_email = 'tanguy.fardet@univ-paris-diderot.fr',
+    license = 'GNU General Public License v2 (GPLv2)',
+    keywords = 'neuronal network growth simulation topology',
+    zip_safe = False
+)
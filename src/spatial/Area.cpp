@@ -47,6 +47,19 @@ Area::Area(BMultiPolygonPtr area, double height, const std::string &name,
             l.insert(l.end(), inner.begin(), inner.end());
         }
     }
+
+    // index the boundary segments
+    std::vector<BSegment> segments;
+
+    for (const auto &line : boundary_)
+    {
+        for (stype i = 1; i < line.size(); i++)
+        {
+            segments.push_back(BSegment(line[i - 1], line[i]));
+        }
+    }
+
+    walls_ = bgi::rtree<BSegment, bgi::quadratic<16>>(segments);
 }
 
 
@@ -90,4 +103,17 @@ const BMultiPolygonPtr Area::get_area() const { return shape_; }
 
 const BMultiLineString &Area::get_boundary() const { return boundary_; }
 
+
+/**
+ * @brief get the boundary segments within `radius` of `p` (bounding box test)
+ */
+void Area::get_walls_in_range(const BPoint &p, double radius,
+                              std::vector<BSegment> &walls) const
+{
+    BBox box(BPoint(p.x() - radius, p.y() - radius),
+             BPoint(p.x() + radius, p.y() + radius));
+
+    walls_.query(bgi::intersects(box), std::back_inserter(walls));
+}
+
 } // namespace growth
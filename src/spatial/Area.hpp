@@ -50,10 +50,13 @@ class Area
     void
     get_properties(std::unordered_map<std::string, double> &properties) const;
     const BMultiLineString &get_boundary() const;
+    void get_walls_in_range(const BPoint &p, double radius,
+                            std::vector<BSegment> &walls) const;
 
   private:
     BMultiPolygonPtr shape_;
     BMultiLineString boundary_;
+    bgi::rtree<BSegment, bgi::quadratic<16>> walls_; // boundary segments
     std::string name_;
     double height_;
     std::unordered_map<std::string, double> properties_;
@@ -0,0 +1,328 @@
+/*
+ * DistanceField.cpp
+ *
+ * This file is part of DeNSE.
+ *
+ * Copyright (C) 2019 SeNEC Initiative
+ *
+ * DeNSE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * DeNSE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DeNSE. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DistanceField.hpp"
+
+// C++ includes
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+
+// maximal number of cells in the grid (coarser resolution is used otherwise)
+#define MAX_FIELD_CELLS 4194304
+// cells closer than this number of cells from a wall are refined
+#define REFINED_CELLS 2.
+
+
+namespace growth
+{
+
+typedef std::pair<BSegment, stype> SegmentValue;
+
+
+/**
+ * @brief Distance from a point to a segment and closest point on the segment
+ */
+double point_segment_distance(const BPoint &p, const BSegment &s,
+                              BPoint &closest)
+{
+    double x0(s.first.x()), y0(s.first.y());
+    double dx(s.second.x() - x0), dy(s.second.y() - y0);
+    double len2 = dx * dx + dy * dy;
+    double t    = 0.;
+
+    if (len2 > 0)
+    {
+        t = ((p.x() - x0) * dx + (p.y() - y0) * dy) / len2;
+        t = std::max(0., std::min(1., t));
+    }
+
+    closest = BPoint(x0 + t * dx, y0 + t * dy);
+
+    return std::sqrt((p.x() - closest.x()) * (p.x() - closest.x()) +
+                     (p.y() - closest.y()) * (p.y() - closest.y()));
+}
+
+
+DistanceField::DistanceField(BMultiPolygonPtr environment,
+                             const BMultiLineString &walls, double resolution)
+    : environment_(environment)
+    , resolution_(resolution)
+{
+    // get the wall segments
+    std::vector<SegmentValue> values;
+
+    for (const auto &line : walls)
+    {
+        for (stype i = 1; i < line.size(); i++)
+        {
+            values.push_back(
+                std::make_pair(BSegment(line[i - 1], line[i]), values.size()));
+            segments_.push_back(values.back().first);
+        }
+    }
+
+    // packing constructor for the segment tree
+    bgi::rtree<SegmentValue, bgi::quadratic<16>> tree(values);
+
+    // make the grid, padded by one cell around the environment
+    BBox envelope;
+    bg::envelope(*(environment_.get()), envelope);
+
+    double width  = envelope.max_corner().x() - envelope.min_corner().x();
+    double height = envelope.max_corner().y() - envelope.min_corner().y();
+
+    resolution_ =
+        std::max(resolution_, std::sqrt(width * height / MAX_FIELD_CELLS));
+
+    half_diagonal_ = 0.5 * std::sqrt(2.) * resolution_;
+
+    xmin_ = envelope.min_corner().x() - resolution_;
+    ymin_ = envelope.min_corner().y() - resolution_;
+    nx_   = static_cast<stype>(std::ceil(width / resolution_)) + 2;
+    ny_   = static_cast<stype>(std::ceil(height / resolution_)) + 2;
+
+    stype num_cells = nx_ * ny_;
+
+    distance_ = std::vector<float>(num_cells);
+    inside_   = std::vector<signed char>(num_cells);
+
+    // crossings of each row with the environment rings (parity test)
+    std::vector<std::vector<double>> row_crossings(ny_);
+
+    auto add_crossings = [this, &row_crossings](const BRing &ring) {
+        for (stype i = 1; i < ring.size(); i++)
+        {
+            const BPoint &p = ring[i - 1];
+            const BPoint &q = ring[i];
+
+            double y0(std::min(p.y(), q.y())), y1(std::max(p.y(), q.y()));
+
+            // rows whose center y is in [y0, y1)
+            long j0 = std::ceil((y0 - ymin_) / resolution_ - 0.5);
+            long j1 = std::ceil((y1 - ymin_) / resolution_ - 0.5);
+
+            for (long j = std::max(j0, 0L);
+                 j < std::min(j1, static_cast<long>(ny_)); j++)
+            {
+                double y = ymin_ + (j + 0.5) * resolution_;
+                row_crossings[j].push_back(
+                    p.x() + (y - p.y()) * (q.x() - p.x()) / (q.y() - p.y()));
+            }
+        }
+    };
+
+    for (const auto &polygon : *(environment_.get()))
+    {
+        add_crossings(polygon.outer());
+
+        for (const auto &inner : polygon.inners())
+        {
+            add_crossings(inner);
+        }
+    }
+
+    double band = REFINED_CELLS * resolution_;
+
+    std::vector<unsigned int> cell_count(num_cells, 0);
+    std::vector<std::vector<unsigned int>> row_candidates(ny_);
+
+#pragma omp parallel for schedule(dynamic)
+    for (long j = 0; j < static_cast<long>(ny_); j++)
+    {
+        std::vector<double> &crossings = row_crossings[j];
+        std::sort(crossings.begin(), crossings.end());
+
+        std::vector<SegmentValue> returned_values;
+        stype n_cross = 0;
+        double y      = ymin_ + (j + 0.5) * resolution_;
+
+        for (stype i = 0; i < nx_; i++)
+        {
+            stype cell = j * nx_ + i;
+            double x   = xmin_ + (i + 0.5) * resolution_;
+            BPoint center(x, y), closest;
+
+            while (n_cross < crossings.size() and crossings[n_cross] < x)
+            {
+                n_cross++;
+            }
+
+            inside_[cell] = (n_cross % 2) ? 1 : -1;
+
+            if (values.empty())
+            {
+                distance_[cell] = std::numeric_limits<float>::infinity();
+                continue;
+            }
+
+            // nearest wall
+            returned_values.clear();
+            tree.query(bgi::nearest(center, 1),
+                       std::back_inserter(returned_values));
+
+            double d = point_segment_distance(
+                center, returned_values[0].first, closest);
+
+            distance_[cell] = d;
+
+            // cells which may be crossed by a wall get the exact inside test
+            if (d <= half_diagonal_)
+            {
+                inside_[cell] = 0;
+            }
+
+            // refinement: keep all segments that can be the nearest for a
+            // point of the cell (within d + 2 * half_diagonal_ of the center)
+            if (d <= band)
+            {
+                double dmax = d + 2 * half_diagonal_;
+
+                BBox box(BPoint(x - dmax, y - dmax),
+                         BPoint(x + dmax, y + dmax));
+
+                returned_values.clear();
+                tree.query(bgi::intersects(box),
+                           std::back_inserter(returned_values));
+
+                for (const auto &value : returned_values)
+                {
+                    if (bg::distance(center, value.first) <= dmax)
+                    {
+                        row_candidates[j].push_back(value.second);
+                        cell_count[cell]++;
+                    }
+                }
+            }
+        }
+    }
+
+    // flatten the candidates
+    cell_start_ = std::vector<unsigned int>(num_cells + 1, 0);
+
+    for (stype i = 0; i < num_cells; i++)
+    {
+        cell_start_[i + 1] = cell_start_[i] + cell_count[i];
+    }
+
+    candidates_.reserve(cell_start_.back());
+
+    for (const auto &row : row_candidates)
+    {
+        candidates_.insert(candidates_.end(), row.begin(), row.end());
+    }
+}
+
+
+/**
+ * @brief Distance from `p` to the nearest wall or area border.
+ *
+ * Exact close to the walls, lower bound elsewhere.
+ */
+double DistanceField::get_distance(const BPoint &p) const
+{
+    BPoint center, closest;
+    stype cell = get_cell(p, center);
+
+    if (cell_start_[cell] < cell_start_[cell + 1] and in_grid(p))
+    {
+        return nearest_wall(p, cell, closest);
+    }
+
+    return std::max(distance_[cell] - bg::distance(p, center), 0.);
+}
+
+
+/**
+ * @brief Whether `p` is strictly inside the environment.
+ *
+ * No wall is closer to the center of the cell than any of its points, so
+ * they are all on the same side as the center; only the cells which may be
+ * crossed by a wall need an exact test.
+ */
+bool DistanceField::contains(const BPoint &p) const
+{
+    BPoint center;
+    stype cell = get_cell(p, center);
+
+    if (not in_grid(p))
+    {
+        return false;
+    }
+
+    if (inside_[cell] == 0)
+    {
+        return bg::within(p, *(environment_.get()));
+    }
+
+    return inside_[cell] > 0;
+}
+
+
+double DistanceField::get_resolution() const { return resolution_; }
+
+
+stype DistanceField::get_cell(const BPoint &p, BPoint &center) const
+{
+    long i = std::floor((p.x() - xmin_) / resolution_);
+    long j = std::floor((p.y() - ymin_) / resolution_);
+
+    i = std::max(0L, std::min(i, static_cast<long>(nx_) - 1));
+    j = std::max(0L, std::min(j, static_cast<long>(ny_) - 1));
+
+    center = BPoint(xmin_ + (i + 0.5) * resolution_,
+                    ymin_ + (j + 0.5) * resolution_);
+
+    return j * nx_ + i;
+}
+
+
+bool DistanceField::in_grid(const BPoint &p) const
+{
+    return p.x() >= xmin_ and p.y() >= ymin_ and
+           p.x() <= xmin_ + nx_ * resolution_ and
+           p.y() <= ymin_ + ny_ * resolution_;
+}
+
+
+double DistanceField::nearest_wall(const BPoint &p, stype cell,
+                                   BPoint &closest) const
+{
+    double dmin = std::numeric_limits<double>::infinity();
+    double d;
+    BPoint tmp;
+
+    for (unsigned int k = cell_start_[cell]; k < cell_start_[cell + 1]; k++)
+    {
+        d = point_segment_distance(p, segments_[candidates_[k]], tmp);
+
+        if (d < dmin)
+        {
+            dmin    = d;
+            closest = tmp;
+        }
+    }
+
+    return dmin;
+}
+
+} // namespace growth
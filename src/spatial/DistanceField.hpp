@@ -0,0 +1,86 @@
+/*
+ * DistanceField.hpp
+ *
+ * This file is part of DeNSE.
+ *
+ * Copyright (C) 2019 SeNEC Initiative
+ *
+ * DeNSE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * DeNSE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DeNSE. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DISTANCE_FIELD_H
+#define DISTANCE_FIELD_H
+#ifndef GEOS_USE_ONLY_R_API
+#define GEOS_USE_ONLY_R_API
+#endif
+
+// C++ include
+#include <vector>
+
+// libgrowth include
+#include "elements_types.hpp"
+#include "spatial_types.hpp"
+
+
+namespace growth
+{
+
+/**
+ * @brief Precomputed distance to the walls of the environment.
+ *
+ * The distance field is sampled on a regular grid covering the environment
+ * (walls and area borders are both considered as walls).
+ * Each cell stores the distance from its center to the nearest wall and
+ * whether the center is inside the environment.
+ * Cells which are close to a wall also store the list of the wall segments
+ * which can be the nearest for any point in the cell, so that queries there
+ * are exact.
+ *
+ * Away from the walls, :cpp:func:`DistanceField::get_distance` returns
+ * a lower bound of the distance, which never underestimates it by more than
+ * the cell diagonal, and :cpp:func:`DistanceField::contains` answers from
+ * the cell without any geometric test.
+ */
+class DistanceField
+{
+  public:
+    DistanceField(BMultiPolygonPtr environment, const BMultiLineString &walls,
+                  double resolution);
+
+    double get_distance(const BPoint &p) const;
+    bool contains(const BPoint &p) const;
+    double get_resolution() const;
+
+  private:
+    stype get_cell(const BPoint &p, BPoint &center) const;
+    bool in_grid(const BPoint &p) const;
+    double nearest_wall(const BPoint &p, stype cell, BPoint &closest) const;
+
+    BMultiPolygonPtr environment_;
+    std::vector<BSegment> segments_;
+    double resolution_;
+    double half_diagonal_;
+    double xmin_, ymin_;
+    stype nx_, ny_;
+    // values at the cell centers
+    std::vector<float> distance_;
+    std::vector<signed char> inside_; // 1 inside, -1 outside, 0 on a wall
+    // candidate nearest segments for cells close to walls (CSR storage)
+    std::vector<unsigned int> cell_start_;
+    std::vector<unsigned int> candidates_;
+};
+
+} // namespace growth
+
+#endif /* DISTANCE_FIELD_H */
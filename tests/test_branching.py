@@ -131,5 +131,87 @@ def test_branching():
         "Failed test with state " + str(initial_state)
 
 
+def test_resource_based():
+    '''
+    Resource-based neurites, with the model given by its short name, both
+    for the whole neuron and for a single neurite.
+    '''
+    ds.reset_kernel()
+    ds.set_kernel_status({
+        "resolution": 10.*minute, "environment_required": False,
+        "interactions": False,
+    })
+
+    n0 = ds.create_neurons(
+        params={"position": (0., 0.)*um, "growth_cone_model": "res_po_rt"},
+        num_neurites=2)
+
+    n1 = ds.create_neurons(
+        params={"position": (500., 0.)*um,
+                "growth_cone_model": "run-and-tumble"},
+        num_neurites=2,
+        neurite_params={"axon": {"growth_cone_model": "res_po_rt"}})
+
+    # only the resource-based neurites have the resource observable
+    assert "A" in n0.axon.get_properties("observables")
+    assert "A" in n0.dendrites["dendrite_1"].get_properties("observables")
+    assert "A" in n1.axon.get_properties("observables")
+    assert "A" not in \
+        n1.dendrites["dendrite_1"].get_properties("observables")
+
+    rec = ds.create_recorders(n0, "resource", levels="growth_cone")
+
+    ds.simulate(1.*day)
+
+    # the resource of the growth cones is updated
+    for neurites in ds.get_recording(rec)["resource"]["data"].values():
+        for cones in neurites.values():
+            for values in cones.values():
+                assert len(np.unique(values)) > 1
+
+    n0.axon.get_state("A")
+
+
+def test_compact_geometry():
+    '''
+    The compact storage of the points and segments gives the same morphology
+    as the default storage, within float precision.
+    '''
+    num_neurons = 4
+
+    params = {
+        "position": [(-1000., 0.), (0., 1000.), (1000., 0.), (0., -1000.)]*um,
+        "growth_cone_model": "run-and-tumble",
+        "use_uniform_branching": True,
+        "uniform_branching_rate": 0.02*cph,
+    }
+
+    morphologies = []
+
+    for compact in (False, True):
+        ds.reset_kernel()
+        ds.set_kernel_status({
+            "resolution": 10.*minute, "seeds": [0],
+            "environment_required": False, "compact_geometry": compact,
+        })
+
+        pop = ds.create_neurons(n=num_neurons, params=params,
+                                num_neurites=2)
+
+        ds.simulate(3.*day)
+
+        morphologies.append([
+            [neuron.neurites[name].xy.m for name in sorted(neuron.neurites)]
+            for neuron in pop
+        ])
+
+    for neuron, compact_neuron in zip(*morphologies):
+        for xy, compact_xy in zip(neuron, compact_neuron):
+            assert xy.shape == compact_xy.shape
+            assert np.allclose(xy, compact_xy, rtol=0., atol=1e-3)
+
+
 if __name__ == '__main__':
     test_branching()
+    test_resource_based()
+    test_compact_geometry()
@@ -22,6 +22,8 @@
 
 """ Testing create functions """
 
+import numpy as np
+
 import dense as ds
 from dense.units import *
 
@@ -129,7 +131,26 @@ def test_create_neurites_many_neurons():
     assert neurons[1].d2.speed_growth_cone == 0.029*um/minute
 
 
+def test_create_non_finite_position():
+    '''
+    Neurons with NaN or infinite coordinates are rejected
+    '''
+    for pos in ((np.nan, 0.), (0., np.inf)):
+        ds.reset_kernel()
+
+        failed = False
+
+        try:
+            ds.create_neurons(params={"position": pos*um})
+        except:
+            failed = True
+
+        assert failed
+        assert not ds.get_neurons()
+
+
 if __name__ == "__main__":
     test_create()
     test_create_neurites_one_neuron()
     test_create_neurites_many_neurons()
+    test_create_non_finite_position()
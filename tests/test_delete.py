@@ -149,6 +149,18 @@ def test_delete_neurites():
             assert len(n.neurites) == 1, \
                 "Failed with state " + str(initial_state)
 
+    # unknown neurons are rejected
+    failed = False
+
+    try:
+        ds.delete_neurites("axon", max(int(n) for n in neurons) + 1)
+    except:
+        failed = True
+
+    assert failed, "Failed with state " + str(initial_state)
+    assert len(neurons[0].neurites) == 2, \
+        "Failed with state " + str(initial_state)
+
     ds.delete_neurites()
 
     for n in neurons:
@@ -156,6 +168,120 @@ def test_delete_neurites():
             "Failed with state " + str(initial_state)
 
 
+def _morphologies(neurons):
+    return [
+        [neuron.neurites[name].xy.m for name in sorted(neuron.neurites)]
+        for neuron in sorted(neurons, key=int)
+    ]
+
+
+def test_delete_order():
+    '''
+    The remaining neurons grow the same way whatever the order in which other
+    neurons were deleted (the neurons of each thread stay sorted by gid).
+    '''
+    num_neurons = 20
+    deleted     = [3, 7, 12, 16]
+    positions   = np.random.uniform(-1000, 1000, (num_neurons, 2))*um
+
+    morphologies = []
+
+    for batch in (True, False):
+        ds.reset_kernel()
+        ds.set_kernel_status({
+            "resolution": 10.*minute, "num_local_threads": 4,
+            "seeds": [0, 1, 2, 3], "environment_required": False,
+        })
+
+        ds.create_neurons(num_neurons, num_neurites=2, params={
+            "position": positions, "growth_cone_model": "run-and-tumble",
+        })
+
+        ds.simulate(0.5*day)
+
+        if batch:
+            ds.delete_neurons(deleted)
+        else:
+            for gid in reversed(deleted):
+                ds.delete_neurons(gid)
+
+        ds.simulate(0.5*day)
+
+        remaining = ds.get_neurons()
+
+        assert len(remaining) == num_neurons - len(deleted)
+        assert not set(deleted).intersection(int(n) for n in remaining)
+
+        morphologies.append(_morphologies(remaining))
+
+    for neuron, other in zip(*morphologies):
+        for xy, other_xy in zip(neuron, other):
+            assert np.array_equal(xy, other_xy)
+
+
+def test_delete_events_and_recorders():
+    '''
+    Pending branching events of deleted neurons are dropped and their
+    recordings stop.
+    '''
+    ds.reset_kernel()
+    ds.set_kernel_status({
+        "resolution": 10.*minute, "num_local_threads": 2,
+        "environment_required": False,
+    })
+
+    num_neurons = 10
+
+    params = {
+        "position": np.random.uniform(-1000, 1000, (num_neurons, 2))*um,
+        "growth_cone_model": "run-and-tumble",
+        "use_uniform_branching": True,
+        "uniform_branching_rate": 0.5*cph,
+    }
+
+    neurons = ds.create_neurons(num_neurons, params=params, num_neurites=2)
+
+    rec_gc  = ds.create_recorders(neurons, "num_growth_cones",
+                                  levels="neuron")
+    rec_len = ds.create_recorders(neurons, "length", levels="neuron")
+
+    # branching events are pending when the neurons are deleted
+    ds.simulate(5.*hour)
+
+    num_lengths = {
+        int(n): len(v)
+        for n, v in ds.get_recording(rec_len)["length"]["data"].items()
+    }
+
+    deleted = [int(n) for n in neurons][:5]
+
+    ds.delete_neurons(deleted)
+
+    ds.simulate(1.*day)
+
+    # no branching of deleted neurons after their deletion
+    branching_times = ds.get_recording(rec_gc)["num_growth_cones"]["times"]
+
+    for gid in deleted:
+        times = branching_times.get(gid, [])
+        assert len(times) == 0 or np.max(times) <= 300.
+
+    assert any(len(branching_times[gid]) and
+               np.max(branching_times[gid]) > 300.
+               for gid in set(branching_times).difference(deleted))
+
+    # the recording of deleted neurons stopped
+    lengths = ds.get_recording(rec_len)["length"]["data"]
+
+    for gid, num_values in num_lengths.items():
+        if gid in deleted:
+            assert len(lengths.get(gid, [])) <= num_values
+        else:
+            assert len(lengths[gid]) > num_values
+
+
 if __name__ == "__main__":
     test_delete_neurons()
     test_delete_neurites()
+    test_delete_order()
+    test_delete_events_and_recorders()
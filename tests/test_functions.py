@@ -22,7 +22,11 @@
 
 """ Testing main functions """
 
+import numpy as np
+from shapely.geometry import LinearRing, Polygon
+
 import dense as ds
+from dense import _pygrowth as _pg
 from dense.units import *
 
 
@@ -100,6 +104,61 @@ def test_elements():
     assert neuron == neuron.axon.neuron
 
 
+def _buffered_angle(position, current_angle, radius, walls):
+    '''
+    Angle widening given by the intersections of the walls with the buffered
+    circle (12 points) which was previously used by the kernel.
+    '''
+    x, y  = position
+    diff  = 2*np.pi / 12
+    pts   = [(x + radius*np.cos(-i*diff), y + radius*np.sin(-i*diff))
+             for i in range(12)]
+
+    intsct = LinearRing(pts).intersection(walls)
+
+    if intsct.is_empty:
+        return 0.
+
+    points = getattr(intsct, "geoms", [intsct])
+
+    return min(
+        np.fmod(np.abs(np.arctan2(p.y - y, p.x - x) - current_angle), np.pi)
+        for p in points)
+
+
+def test_unstuck_angle():
+    '''
+    The angle to unstuck a growth cone is the one of the buffered circle.
+    '''
+    ds.reset_kernel()
+    ds.set_kernel_status("interactions", False)
+
+    shape = ds.environment.Shape.rectangle(100., 100.)
+    walls = Polygon([(-50, -50), (50, -50), (50, 50), (-50, 50)]).exterior
+
+    ds.set_environment(shape)
+
+    cases = [
+        ((0., 0.), 0., 10.),      # no wall in range
+        ((40., 0.), 0., 20.),     # one wall
+        ((40., 5.), 0.3, 17.),
+        ((-35., 10.), 2., 25.),
+        ((0., -42.), -1.2, 13.),
+        ((40., 40.), 0.7, 15.),   # corner, two walls
+        ((-45., 38.), 2.6, 21.),
+    ]
+
+    for position, current_angle, radius in cases:
+        angle    = _pg._test_unstuck_angle(position, current_angle, radius)
+        expected = _buffered_angle(position, current_angle, radius, walls)
+
+        assert np.isclose(angle, expected, rtol=0, atol=1e-8), \
+            "{}: {} != {}".format(position, angle, expected)
+
+    assert _pg._test_unstuck_angle((0., 0.), 0., 10.) == 0.
+
+
 if __name__ == '__main__':
     test_functions()
     test_elements()
+    test_unstuck_angle()
@@ -0,0 +1,197 @@
+# -*- coding: utf-8 -*-
+#
+# test_multithreading.py
+#
+# This file is part of DeNSE.
+#
+# Copyright (C) 2019 SeNEC Initiative
+#
+# DeNSE is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# DeNSE is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with DeNSE. If not, see <http://www.gnu.org/licenses/>.
+
+
+""" Testing the multithreading options of the kernel """
+
+import numpy as np
+
+import dense as ds
+from dense.units import *
+
+
+num_omp     = 4
+num_neurons = 40
+simtime     = 1.*day
+
+positions = np.random.uniform(-2000, 2000, (num_neurons, 2))*um
+
+# one neuron in four (all on the first thread) branches much more
+rates = np.where(np.arange(num_neurons) % num_omp == 0, 2., 0.5)*cph
+
+
+def _grow(options, **kwargs):
+    '''
+    Grow the same neurons with `num_omp` threads and the kernel `options`,
+    `kwargs` being added to the neuron parameters.
+
+    The results are read before returning, as the neurons are reset by the
+    next run.
+    '''
+    ds.reset_kernel()
+
+    status = {
+        "resolution": 10.*minute, "num_local_threads": num_omp,
+        "seeds": [2*i for i in range(num_omp)],
+        "environment_required": False,
+    }
+
+    status.update(options)
+
+    ds.set_kernel_status(status)
+
+    params = {
+        "position": positions,
+        "growth_cone_model": "run-and-tumble",
+        "use_uniform_branching": True,
+        "uniform_branching_rate": rates,
+    }
+
+    params.update(kwargs)
+
+    ds.create_neurons(num_neurons, params=params, num_neurites=2)
+
+    ds.simulate(simtime)
+
+    neurons = sorted(ds.get_neurons(), key=int)
+
+    return {
+        "gids": [int(n) for n in neurons],
+        "neurites": [sorted(n.neurites) for n in neurons],
+        "xy": [
+            [n.neurites[name].xy.m for name in sorted(n.neurites)]
+            for n in neurons
+        ],
+        "length": [n.total_length.m for n in neurons],
+        "num_growth_cones": [
+            int(n.neurites[name].get_state("num_growth_cones"))
+            for n in neurons for name in sorted(n.neurites)
+        ],
+    }
+
+
+def _assert_identical(result, other):
+    assert result["gids"] == other["gids"]
+    assert result["neurites"] == other["neurites"]
+
+    for neuron, other_neuron in zip(result["xy"], other["xy"]):
+        for xy, other_xy in zip(neuron, other_neuron):
+            assert np.array_equal(xy, other_xy)
+
+
+def _assert_compatible(result, other):
+    '''
+    Same neurons and neurites, mean total length and number of growth cones
+    equal within their 99.9% confidence interval.
+    '''
+    assert result["gids"] == other["gids"]
+    assert result["neurites"] == other["neurites"]
+
+    for key in ("length", "num_growth_cones"):
+        values, other_values = result[key], other[key]
+
+        error = 3.29*np.sqrt(np.var(values) / len(values) +
+                             np.var(other_values) / len(other_values))
+
+        assert np.abs(np.mean(values) - np.mean(other_values)) < error
+
+
+def test_profiling():
+    '''
+    Profiling does not change the simulation and counts the steps.
+    '''
+    default = _grow({})
+
+    assert not ds.get_kernel_status("profile")
+
+    profiled = _grow({"profiling": True})
+
+    profile = ds.get_kernel_status("profile")
+
+    assert profile["num_threads"] == num_omp
+    assert profile["steps"] > 0
+    assert profile["events"] > 0
+    assert profile["grow_calls"] > 0
+
+    _assert_identical(default, profiled)
+
+
+def test_growth_cone_tasks():
+    '''
+    Growth cone tasks are reproducible and agree with the default mode.
+    '''
+    # closer branches so that some neurites are large enough to be grown as
+    # tasks (at least 8 growth cones)
+    closer  = {"min_branching_distance": 12.*um}
+    default = _grow({}, **closer)
+    tasks   = _grow({"growth_cone_tasks": True}, **closer)
+
+    assert max(tasks["num_growth_cones"]) >= 8
+
+    # the tasks do not depend on the threads which run them
+    _assert_identical(tasks, _grow({"growth_cone_tasks": True}, **closer))
+
+    _assert_compatible(default, tasks)
+
+
+def test_load_balancing():
+    '''
+    Neurons of the overloaded thread are moved and the results agree with
+    the default mode.
+    '''
+    default  = _grow({})
+    balanced = _grow({
+        "load_balancing": True, "load_balancing_interval": 10,
+        "profiling": True,
+    })
+
+    assert ds.get_kernel_status("profile")["migrations"] > 0
+
+    _assert_compatible(default, balanced)
+
+
+def test_asynchronous_events():
+    '''
+    Asynchronous events are reproducible and agree with the default mode,
+    also together with growth cone tasks and load balancing.
+    '''
+    default      = _grow({})
+    asynchronous = _grow({"asynchronous_events": True})
+
+    # threads only share the neurites at the end of each step
+    _assert_identical(asynchronous, _grow({"asynchronous_events": True}))
+
+    _assert_compatible(default, asynchronous)
+
+    # tasks of one thread run by another thread which processes its events
+    combined = _grow({
+        "asynchronous_events": True, "growth_cone_tasks": True,
+        "load_balancing": True, "load_balancing_interval": 10,
+    })
+
+    _assert_compatible(default, combined)
+
+
+if __name__ == "__main__":
+    test_profiling()
+    test_growth_cone_tasks()
+    test_load_balancing()
+    test_asynchronous_events()
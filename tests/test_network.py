@@ -25,7 +25,9 @@
 import numpy as np
 
 import dense as ds
+from dense import _pygrowth as _pg
 from dense.units import *
+from dense.morphology.connections import _generate_network_future
 
 
 np.random.seed(0)
@@ -78,10 +80,68 @@ def test_2neuron_network(plot=True):
     assert net.edge_nb() == 1, \
         "Incorrect number of edges in the network"
 
-    assert net.get_edge_attributes(name="weight")[0] == 2, \
+    # the overlap gives 0.5 synapse per um^2 on average, rounded randomly
+    area     = np.sum(_pg._get_contacts([0, 1], [0, 1])["area"])
+    expected = 2*np.floor(0.5*area), 2*np.ceil(0.5*area)
+
+    assert net.get_edge_attributes(name="weight")[0] in expected, \
         "Incorrect weight"
 
 
+def test_network_future():
+    '''
+    Network generated from the synapses returned by the C++ routines
+    '''
+    ds.reset_kernel()
+    ds.set_kernel_status("resolution", 10.*minute)
+
+    num_neurons = 2
+    params      = {
+        "position": [(0, 0), (20, -20)]*um,
+        "growth_cone_model": "run-and-tumble",
+        "neurite_angles": [
+            {"axon": 90.*deg, "dendrite_1": 270.*deg},
+            {"axon": 180.*deg, "dendrite_1": 60.*deg},
+        ],
+    }
+
+    neurons = ds.create_neurons(num_neurons, params, num_neurites=2)
+
+    ds.simulate(0.45*day)
+
+    # potential synaptic sites are not recorded during growth, so the
+    # synapses are given as they would be returned by the C++ routines:
+    # two from the axon of 1 to the dendrite of 0, one from 0 to 1
+    def synapses():
+        return {
+            "source_neuron": [1, 1, 0], "target_neuron": [0, 0, 1],
+            "source_neurite": [b"axon"]*3,
+            "target_neurite": [b"dendrite_1"]*3,
+            "source_node": [1, 1, 1], "target_node": [1, 1, 1],
+            "source_segment": [0, 1, 0], "target_segment": [0, 1, 0],
+            "source_pos_x": [0., 1., 2.], "source_pos_y": [0., 1., 2.],
+            "target_pos_x": [0., 1., 2.], "target_pos_y": [0., 1., 2.],
+        }
+
+    net = _generate_network_future(method="intersections", data=synapses())
+
+    assert net.node_nb() == num_neurons, \
+        "Incorrect node number in the network"
+
+    assert net.edge_nb() == 2, \
+        "Incorrect number of edges in the network"
+
+    # the multigraph keeps one edge per synapse
+    net = _generate_network_future(method="intersections", data=synapses(),
+                                   multigraph=True)
+
+    assert net.node_nb() == num_neurons, \
+        "Incorrect node number in the network"
+
+    assert net.edge_nb() == 3, \
+        "Incorrect number of edges in the network"
+
+
 def test_network(plot=False):
     '''
     Bigger network
@@ -114,6 +174,163 @@ def test_network(plot=False):
         str(initial_state)
 
 
+def test_contact_log_deletion():
+    '''
+    Contacts of deleted neurons and neurites leave the contact log
+    '''
+    ds.reset_kernel()
+    ds.set_kernel_status({
+        "resolution": 10.*minute, "track_contacts": True,
+    })
+
+    num_neurons = 30
+    positions   = np.random.uniform(-100, 100, (num_neurons, 2))*um
+    params      = {
+        "position": positions, "growth_cone_model": "run-and-tumble",
+    }
+
+    neurons = ds.create_neurons(num_neurons, params, num_neurites=3)
+
+    ds.simulate(0.45*day)
+
+    log = _pg._get_contact_log()
+
+    assert len(log["area"]) > 0, "No contact was recorded"
+
+    deleted = [int(n) for n in neurons][:5]
+
+    ds.delete_neurons(deleted)
+    ds.delete_neurites("dendrite_1")
+
+    log = _pg._get_contact_log()
+
+    for key in ("source_neuron", "target_neuron"):
+        assert not np.any(np.isin(log[key], deleted)), \
+            "Contacts of deleted neurons are still logged"
+
+    assert "dendrite_1" not in log["target_neurite"], \
+        "Contacts of deleted neurites are still logged"
+
+    # growth goes on with the remaining neurons
+    ds.simulate(0.1*day)
+
+    _pg._get_contact_log(only_new=True)
+
+
+def _contact_keys(contacts):
+    return list(zip(
+        contacts["source_neuron"], contacts["source_neurite"],
+        contacts["source_node"], contacts["source_segment"],
+        contacts["target_neuron"], contacts["target_neurite"],
+        contacts["target_node"], contacts["target_segment"]))
+
+
+def test_contact_log():
+    '''
+    Contacts logged during growth against those computed afterwards
+    '''
+    ds.reset_kernel()
+    ds.set_kernel_status({
+        "resolution": 10.*minute, "track_contacts": True,
+    })
+
+    num_neurons = 30
+    positions   = np.random.uniform(-100, 100, (num_neurons, 2))*um
+    params      = {
+        "position": positions, "growth_cone_model": "run-and-tumble",
+    }
+
+    neurons = ds.create_neurons(num_neurons, params, num_neurites=3)
+    gids    = [int(n) for n in neurons]
+
+    ds.simulate(0.3*day)
+
+    log  = _pg._get_contact_log()
+    keys = _contact_keys(log)
+
+    assert keys, "No contact was recorded"
+    assert len(set(keys)) == len(keys), "Duplicate contacts in the log"
+
+    # all logged contacts still exist
+    contacts = _pg._get_contacts(gids, gids, 0., True)
+
+    assert set(keys).issubset(_contact_keys(contacts)), \
+        "The log contains contacts which do not exist"
+
+    # nothing new since the log was read
+    assert len(_pg._get_contact_log(only_new=True)["area"]) == 0
+
+    edges, _, _ = ds.morphology.get_connections(
+        connection_probability=1., only_new_connections=True)
+
+    assert len(edges) == 0, "Old contacts returned as new connections"
+
+    t     = ds.get_kernel_status("time")
+    start = 1440*t.day + 60*t.hour + t.minute + t.second/60.
+
+    ds.simulate(0.2*day)
+
+    new = _pg._get_contact_log(only_new=True)
+    log = _pg._get_contact_log()
+
+    # segments rebuilt since the first run are logged again with their new
+    # geometry, the log keeps a single entry per contact
+    full_keys = _contact_keys(log)
+
+    assert len(set(full_keys)) == len(full_keys), \
+        "Duplicate contacts in the log"
+
+    if len(new["time"]):
+        assert np.min(new["time"]) >= start
+
+    assert set(_contact_keys(new)).issubset(full_keys)
+
+    edges, _, _ = ds.morphology.get_connections(
+        connection_probability=1., spine_density=10./um**2)
+
+    assert len(edges) > 0, "No connection from the contact log"
+
+
+def test_status_after_start():
+    '''
+    Space parameters can be set after the simulation started, except the
+    maximal synaptic distance
+    '''
+    ds.reset_kernel()
+    ds.set_kernel_status({
+        "resolution": 10.*minute, "max_synaptic_distance": 2.*um,
+    })
+
+    ds.create_neurons(2, {"position": [(0, 0), (20, -20)]*um},
+                      num_neurites=2)
+
+    ds.simulate(1.*hour)
+
+    ds.set_kernel_status({
+        "track_contacts": True, "max_synaptic_distance": 2.*um,
+    })
+
+    assert ds.get_kernel_status("track_contacts")
+
+    # invalid changes are rejected before any value is set
+    failed = False
+
+    try:
+        ds.set_kernel_status({
+            "track_contacts": False, "max_synaptic_distance": 3.*um,
+        })
+    except:
+        failed = True
+
+    assert failed
+    assert ds.get_kernel_status("track_contacts")
+    assert ds.get_kernel_status("max_synaptic_distance") == 2.*um
+
+
 if __name__ == "__main__":
     test_2neuron_network(True)
+    test_network_future()
     test_network(True)
+    test_contact_log()
+    test_contact_log_deletion()
+    test_status_after_start()